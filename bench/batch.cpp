@@ -0,0 +1,311 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "math/basic_types.h"
+#include "math/batch.h"
+#include "math/cpu.h"
+
+// An IRect inside a bigger struct so the stride isn't just sizeof(IRect)
+struct FrameLike
+{
+    IRect rect;
+    f32   duration;
+};
+
+static Vector4 ReferenceIRect(const Transform2D& transform, const IRect& rect)
+{
+    Vector2 a = transform.Apply(Vector2((f32) rect.x, (f32) rect.y));
+    Vector2 b = transform.Apply(Vector2((f32) rect.MaxX(), (f32) rect.MaxY()));
+
+    f32 x = fminf(a.x, b.x);
+    f32 y = fminf(a.y, b.y);
+    return Vector4(x, y, fmaxf(a.x, b.x) - x, fmaxf(a.y, b.y) - y);
+}
+
+static bool NearlyEqual(const Vector4& a, const Vector4& b)
+{
+    for (int i = 0; i < 4; i++)
+    {
+        if (fabsf(a.data[i] - b.data[i]) > 1e-3f * fmaxf(1.0f, fabsf(b.data[i])))
+            return false;
+    }
+
+    return true;
+}
+
+static bool NearlyEqual(const Vector2& a, const Vector2& b)
+{
+    return fabsf(a.x - b.x) <= 1e-3f * fmaxf(1.0f, fabsf(b.x)) &&
+           fabsf(a.y - b.y) <= 1e-3f * fmaxf(1.0f, fabsf(b.y));
+}
+
+// The dispatched TransformPoints against Matrix3x2 * Vector2, counts cover the SSE pairs, AVX2 quads and tails
+static void CheckTransformPoints()
+{
+    std::mt19937 random(11);
+    std::uniform_real_distribution<f32> coordinate(-4096.0f, 4096.0f);
+
+    std::vector<Vector2> points(1003);
+    for (Vector2& point : points)
+        point = Vector2(coordinate(random), coordinate(random));
+
+    const Matrix3x2 transforms[] = {
+        Matrix3x2(),
+        Matrix3x2::ScreenToNDC(1920.0f, 1080.0f) * Matrix3x2::Translation(Vector2(-300.0f, 42.0f)),
+        Matrix3x2::Rotation(0.7f) * Matrix3x2::Scaling(Vector2(-1.5f, 0.25f)),
+    };
+
+    const size_t counts[] = { 0, 1, 2, 3, 4, 5, 7, points.size() };
+
+    std::vector<Vector2> out(points.size());
+    for (const Matrix3x2& transform : transforms)
+    {
+        for (size_t count : counts)
+        {
+            TransformPoints(transform, points.data(), out.data(), count);
+
+            bool matches = true;
+            for (size_t i = 0; i < count; i++)
+                matches = matches && NearlyEqual(out[i], transform * points[i]);
+
+            BENCH_CHECK(matches);
+        }
+
+        // In place
+        std::vector<Vector2> inPlace = points;
+        TransformPoints(transform, inPlace.data(), inPlace.data(), inPlace.size());
+
+        bool matches = true;
+        for (size_t i = 0; i < points.size(); i++)
+            matches = matches && NearlyEqual(inPlace[i], transform * points[i]);
+
+        BENCH_CHECK(matches);
+    }
+}
+
+static bool NearlyEqual(const Matrix4& a, const Matrix4& b)
+{
+    for (int column = 0; column < 4; column++)
+    {
+        if (!NearlyEqual(Vector4(a.sseColumns[column]), Vector4(b.sseColumns[column])))
+            return false;
+    }
+
+    return true;
+}
+
+static std::vector<Vector4> RandomVectors(size_t count, u32 seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_real_distribution<f32> value(-100.0f, 100.0f);
+
+    std::vector<Vector4> vectors(count);
+    for (Vector4& v : vectors)
+        v = Vector4(value(random), value(random), value(random), value(random));
+
+    // Normalize leaves these as they are
+    vectors[0] = Vector4(0.0f);
+    vectors[count / 2] = Vector4(0.0f);
+
+    return vectors;
+}
+
+static bool AllNearlyEqual(const std::vector<Vector4>& a, const std::vector<Vector4>& b, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!NearlyEqual(a[i], b[i]))
+            return false;
+    }
+
+    return true;
+}
+
+using TransformVectorsFn = void (*)(const Matrix4&, const Vector4*, Vector4*, size_t);
+using NormalizeVectorsFn = void (*)(const Vector4*, Vector4*, size_t);
+using LerpVectorsFn      = void (*)(const Vector4*, const Vector4*, f32, Vector4*, size_t);
+
+struct Vector4Path
+{
+    const char* name;
+    TransformVectorsFn transform;
+    NormalizeVectorsFn normalize;
+    LerpVectorsFn      lerp;
+};
+
+// The SSE and AVX2 paths of the 4D kernels against the scalar ones, out of place and in place,
+// for counts that cover the AVX2 pairs and the odd tail. Then the dispatched MultiplyMatrices
+// against Matrix4 * Matrix4.
+static void CheckVector4Kernels()
+{
+    const CpuFeatures& cpu = GetCpuFeatures();
+
+    const Vector4Path paths[] = {
+        { "sse", TransformVectorsSSE, NormalizeVectorsSSE, LerpVectorsSSE },
+        { "avx2", TransformVectorsAVX2, NormalizeVectorsAVX2, LerpVectorsAVX2 },
+    };
+
+    const size_t pathCount = (cpu.avx2 && cpu.fma) ? 2 : 1;
+
+    const size_t vectorCount = 1001;
+    std::vector<Vector4> a = RandomVectors(vectorCount, 1);
+    std::vector<Vector4> b = RandomVectors(vectorCount, 2);
+
+    const Matrix4 transform = Matrix4::Translation(Vector3(3.0f, -7.0f, 0.5f)) *
+                              Matrix4::Rotation(Vector3(1.0f, 2.0f, 3.0f), 0.8f) *
+                              Matrix4(2.0f, 0.5f, -1.0f);
+
+    const size_t counts[] = { 0, 1, 2, 3, 17, vectorCount };
+    const f32 ts[] = { 0.0f, 0.37f, 1.0f };
+
+    std::vector<Vector4> expected(vectorCount), out(vectorCount);
+    for (size_t p = 0; p < pathCount; p++)
+    {
+        const Vector4Path& path = paths[p];
+
+        for (size_t count : counts)
+        {
+            TransformVectorsScalar(transform, a.data(), expected.data(), count);
+            path.transform(transform, a.data(), out.data(), count);
+            BENCH_CHECK(AllNearlyEqual(out, expected, count));
+
+            NormalizeVectorsScalar(a.data(), expected.data(), count);
+            path.normalize(a.data(), out.data(), count);
+            BENCH_CHECK(AllNearlyEqual(out, expected, count));
+
+            for (f32 t : ts)
+            {
+                LerpVectorsScalar(a.data(), b.data(), t, expected.data(), count);
+                path.lerp(a.data(), b.data(), t, out.data(), count);
+                BENCH_CHECK(AllNearlyEqual(out, expected, count));
+            }
+        }
+
+        // In place
+        out = a;
+        TransformVectorsScalar(transform, a.data(), expected.data(), vectorCount);
+        path.transform(transform, out.data(), out.data(), vectorCount);
+        BENCH_CHECK(AllNearlyEqual(out, expected, vectorCount));
+
+        out = a;
+        NormalizeVectorsScalar(a.data(), expected.data(), vectorCount);
+        path.normalize(out.data(), out.data(), vectorCount);
+        BENCH_CHECK(AllNearlyEqual(out, expected, vectorCount));
+        BENCH_CHECK(out[0] == Vector4(0.0f) && out[vectorCount / 2] == Vector4(0.0f));
+
+        out = a;
+        LerpVectorsScalar(a.data(), b.data(), 0.37f, expected.data(), vectorCount);
+        path.lerp(out.data(), b.data(), 0.37f, out.data(), vectorCount);
+        BENCH_CHECK(AllNearlyEqual(out, expected, vectorCount));
+
+        // Lands exactly on the ends
+        path.lerp(a.data(), b.data(), 1.0f, out.data(), vectorCount);
+        BENCH_CHECK(std::equal(out.begin(), out.end(), b.begin()));
+    }
+
+    std::vector<Matrix4> rights(33), products(33);
+    for (size_t i = 0; i < rights.size(); i++)
+        rights[i] = Matrix4::Rotation(Vector3(a[i + 1].x, a[i + 1].y, a[i + 1].z), a[i + 1].w) * Matrix4((f32) i + 1.0f);
+
+    MultiplyMatrices(transform, rights.data(), products.data(), rights.size());
+
+    bool matches = true;
+    for (size_t i = 0; i < rights.size(); i++)
+        matches = matches && NearlyEqual(products[i], transform * rights[i]);
+
+    BENCH_CHECK(matches);
+
+    // Timings, 100k vectors through each path
+    std::vector<Vector4> big = RandomVectors(100000, 3);
+    std::vector<Vector4> bigOut(big.size());
+    const u64 repeats = 100;
+
+    const Vector4Path timed[] = {
+        { "scalar", TransformVectorsScalar, NormalizeVectorsScalar, LerpVectorsScalar },
+        paths[0],
+        paths[1],
+    };
+
+    for (size_t p = 0; p < pathCount + 1; p++)
+    {
+        char name[64];
+
+        BenchTimer timer;
+        for (u64 i = 0; i < repeats; i++)
+            timed[p].transform(transform, big.data(), bigOut.data(), big.size());
+
+        snprintf(name, sizeof(name), "TransformVectors %s, 100k", timed[p].name);
+        ReportResult("batch", name, timer.ElapsedMs() / repeats, big.size());
+
+        timer = BenchTimer();
+        for (u64 i = 0; i < repeats; i++)
+            timed[p].normalize(big.data(), bigOut.data(), big.size());
+
+        snprintf(name, sizeof(name), "NormalizeVectors %s, 100k", timed[p].name);
+        ReportResult("batch", name, timer.ElapsedMs() / repeats, big.size());
+    }
+}
+
+// Compares the dispatched TransformIRects against the plain math, counts cover the AVX2 pairs and the odd tail
+void RunBatchBench()
+{
+    const CpuFeatures& cpu = GetCpuFeatures();
+    printf("  avx2 %d, fma %d\n", cpu.avx2, cpu.fma);
+
+    CheckTransformPoints();
+    CheckVector4Kernels();
+
+    std::mt19937 random(7);
+    std::uniform_int_distribution<s32> position(0, 16384);
+    std::uniform_int_distribution<s32> size(1, 512);
+
+    std::vector<FrameLike> frames(100001);
+    for (FrameLike& frame : frames)
+        frame.rect = IRect(position(random), position(random), size(random), size(random));
+
+    const Transform2D transforms[] = {
+        Transform2D(),
+        FlipY2D(16384.0f),
+        Compose(FlipY2D(16384.0f), Compose(Scale2D(Vector2(1.5f, 0.25f)), Translate2D(Vector2(-300.0f, 42.0f)))),
+        Scale2D(Vector2(-2.0f, -1.0f)),
+    };
+
+    const size_t counts[] = { 0, 1, 2, 3, 17, frames.size() };
+
+    std::vector<Vector4> out(frames.size());
+    for (const Transform2D& transform : transforms)
+    {
+        for (size_t count : counts)
+        {
+            TransformIRects(transform, &frames[0].rect, sizeof(FrameLike), out.data(), count);
+
+            bool matches = true;
+            for (size_t i = 0; i < count; i++)
+                matches = matches && NearlyEqual(out[i], ReferenceIRect(transform, frames[i].rect));
+
+            BENCH_CHECK(matches);
+        }
+    }
+
+    const u64 repeats = 100;
+    const Transform2D& transform = transforms[2];
+
+    BenchTimer timer;
+    for (u64 i = 0; i < repeats; i++)
+    {
+        for (size_t j = 0; j < frames.size(); j++)
+            out[j] = ReferenceIRect(transform, frames[j].rect);
+    }
+
+    ReportResult("batch", "TransformIRects scalar, 100k rects", timer.ElapsedMs() / repeats, frames.size());
+
+    timer = BenchTimer();
+    for (u64 i = 0; i < repeats; i++)
+        TransformIRects(transform, &frames[0].rect, sizeof(FrameLike), out.data(), frames.size());
+
+    ReportResult("batch", "TransformIRects dispatched, 100k rects", timer.ElapsedMs() / repeats, frames.size());
+}
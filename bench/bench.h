@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+#include "math/basic_types.h"
+
+// Correctness checks and timings for the containers and math kernels, built on their own with
+// build_bench.bat. Checks stay on in release builds since the timings are only worth
+// something when the results are right.
+
+#define BENCH_CHECK(x) BenchCheck(!!(x), #x, __FILE__, __LINE__)
+
+bool BenchCheck(bool passed, const char* expression, const char* file, int line);
+
+struct BenchTimer
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    inline f64 ElapsedMs() const
+    {
+        return std::chrono::duration<f64, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+// ops is how many operations the timed code did, used for the per op time
+void ReportResult(const char* suite, const char* name, f64 ms, u64 ops);
+
+// Suites, one per file
+void RunQueueBench();
+void RunHashBench();
+void RunConcurrentTableBench();
+void RunBitsetBench();
+void RunContainerBench();
+void RunBatchBench();
+void RunIRectBench();
+void RunSoaDarrayBench();
+void RunPersistentVectorBench();
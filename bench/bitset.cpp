@@ -0,0 +1,63 @@
+#include "bench.h"
+
+#include <random>
+#include "containers/bitset.h"
+#include "math/basic_types.h"
+#include "math/cpu.h"
+
+// Both paths are checked against each other when the CPU has AVX2, the dispatched one is timed
+void RunBitsetBench()
+{
+    const size_t bitCount = 1 << 22;    // A 2048 x 2048 opacity bitmap
+
+    gn::bitset bits(bitCount);
+    std::mt19937_64 random(42);
+
+    size_t expected = 0;
+    for (size_t i = 0; i < bitCount; i++)
+    {
+        if (random() % 3 == 0)
+        {
+            bits.set(i);
+            expected++;
+        }
+    }
+
+    const u64* words = bits.words();
+    size_t wordCount = bits.word_count();
+
+    BENCH_CHECK(bits.count() == expected);
+    BENCH_CHECK(bits.any());
+    BENCH_CHECK(gn::bits_count_words_scalar(words, wordCount) == expected);
+
+    if (GetCpuFeatures().avx2)
+    {
+        BENCH_CHECK(gn::bits_count_words_avx2(words, wordCount) == expected);
+        BENCH_CHECK(gn::bits_any_words_avx2(words, wordCount));
+    }
+
+    // Only the last bit set, any() has to scan everything
+    gn::bitset last(bitCount);
+    last.set(bitCount - 1);
+
+    BENCH_CHECK(last.count() == 1);
+    BENCH_CHECK(last.any());
+    BENCH_CHECK(gn::bitset(bitCount).none());
+
+    const u64 repeats = 200;
+    size_t sink = 0;
+
+    BenchTimer timer;
+    for (u64 i = 0; i < repeats; i++)
+        sink += gn::bits_count_words_scalar(words, wordCount);
+
+    ReportResult("bitset", "count scalar, 4M bits", timer.ElapsedMs() / repeats, wordCount);
+
+    timer = BenchTimer();
+    for (u64 i = 0; i < repeats; i++)
+        sink += bits.count();
+
+    ReportResult("bitset", "count dispatched, 4M bits", timer.ElapsedMs() / repeats, wordCount);
+
+    BENCH_CHECK(sink == 2 * repeats * expected);
+}
@@ -0,0 +1,149 @@
+#include "bench.h"
+
+#include <atomic>
+#include <cstdio>
+#include <numeric>
+#include <thread>
+#include <vector>
+#include "containers/common_hashes.h"
+#include "containers/concurrent_table.h"
+#include "math/basic_types.h"
+
+static constexpr s32 threadCounts[] = { 1, 2, 4, 8, 16, 32 };
+static constexpr u64 keyCount = 200000;      // Every thread works on all of them
+
+// Coprime to keyCount so a thread stepping by it visits every key, different per thread
+static u64 StrideForThread(s32 thread)
+{
+    u64 stride = 7919 + 2 * (u64) thread;
+    while (std::gcd(stride, keyCount) != 1)
+        stride++;
+
+    return stride;
+}
+
+// Every thread tries to insert every key, in a different order per thread. Exactly one
+// insert per key may win and every thread has to see the winner's value from then on.
+static void InsertAndFindOverlapping(s32 threadCount)
+{
+    gn::concurrent_table<u64, s32> table;
+
+    std::vector<std::atomic<s32>> winners(keyCount);
+    for (auto& winner : winners)
+        winner.store(-1);
+
+    std::atomic<u64> wins { 0 };
+    std::atomic<u64> mismatches { 0 };
+
+    BenchTimer timer;
+
+    std::vector<std::thread> threads;
+    for (s32 t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&, t]()
+        {
+            u64 stride = StrideForThread(t);
+            u64 key = (u64) t * 12345 % keyCount;
+
+            for (u64 i = 0; i < keyCount; i++, key = (key + stride) % keyCount)
+            {
+                auto result = table.insert_or_get(key, t);
+
+                if (result.inserted)
+                {
+                    wins.fetch_add(1, std::memory_order_relaxed);
+
+                    s32 expected = -1;
+                    if (!winners[key].compare_exchange_strong(expected, t))
+                        mismatches.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                s32 found = -1;
+                if (!table.find(key, found) || found != result.value)
+                    mismatches.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    char label[64];
+    snprintf(label, sizeof(label), "insert_or_get + find, %d threads", threadCount);
+    ReportResult("concurrent_table", label, timer.ElapsedMs(), keyCount * threadCount * 2);
+
+    BENCH_CHECK(wins.load() == keyCount);
+    BENCH_CHECK(mismatches.load() == 0);
+    BENCH_CHECK(table.size() == keyCount);
+
+    u64 wrong = 0;
+    for (u64 key = 0; key < keyCount; key++)
+    {
+        s32 value = -1;
+        if (!table.find(key, value) || value != winners[key].load())
+            wrong++;
+    }
+
+    BENCH_CHECK(wrong == 0);
+}
+
+// Writers overwrite keys with values tied to the key while readers look them up,
+// a reader must only ever see a value that some writer stored for that key.
+// Even threads write and odd ones read, a single thread only writes.
+static void SetWhileReading(s32 threadCount)
+{
+    gn::concurrent_table<u64, u64> table;
+
+    std::atomic<u64> torn { 0 };
+    std::atomic<u64> found { 0 };
+
+    BenchTimer timer;
+
+    std::vector<std::thread> threads;
+    for (s32 t = 0; t < threadCount; t++)
+    {
+        bool writer = t % 2 == 0;
+
+        threads.emplace_back([&, t, writer]()
+        {
+            for (u64 i = 0; i < keyCount; i++)
+            {
+                u64 key = (i * 31 + t) % (keyCount / 4);
+
+                if (writer)
+                {
+                    table.set(key, (key << 8) | (u64) t);
+                    continue;
+                }
+
+                u64 value;
+                if (table.find(key, value))
+                {
+                    found.fetch_add(1, std::memory_order_relaxed);
+                    if ((value >> 8) != key || (value & 0xFF) % 2 != 0)
+                        torn.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    char label[64];
+    snprintf(label, sizeof(label), "set + find, %d writers %d readers", (threadCount + 1) / 2, threadCount / 2);
+    ReportResult("concurrent_table", label, timer.ElapsedMs(), keyCount * threadCount);
+
+    BENCH_CHECK(torn.load() == 0);
+    BENCH_CHECK(table.size() == keyCount / 4);
+}
+
+// Same work per thread at every count, so ns/op shows how the shards hold up as threads are added
+void RunConcurrentTableBench()
+{
+    for (s32 threadCount : threadCounts)
+        InsertAndFindOverlapping(threadCount);
+
+    for (s32 threadCount : threadCounts)
+        SetWhileReading(threadCount);
+}
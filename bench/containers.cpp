@@ -0,0 +1,347 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "containers/common_hashes.h"
+#include "containers/darray.h"
+#include "containers/hash_table.h"
+#include "containers/ordered_table.h"
+#include "containers/slot_map.h"
+#include "math/basic_types.h"
+
+// Each gn container next to the std container it stands in for, same keys and same work,
+// over a range of sizes from a handful of elements to far more than fit in cache
+static constexpr size_t sweepSizes[] = { 10, 1000, 100000, 10000000 };
+static constexpr size_t stringSweepSizes[] = { 10, 1000, 100000, 1000000 };
+static constexpr size_t slotMapCount = 1000000;
+
+// Small sizes are repeated up to about this many operations so the timer has something to measure.
+// Results are reported per repeat.
+static constexpr size_t opsPerResult = 1000000;
+
+static u64 sink = 0;    // Results are added here so the loops can't be optimized out
+
+static size_t RepeatsFor(size_t size)
+{
+    return std::max<size_t>(1, opsPerResult / size);
+}
+
+static void ReportSized(const char* name, size_t size, f64 totalMs, size_t repeats)
+{
+    char label[96];
+    snprintf(label, sizeof(label), "%s, n=%zu", name, size);
+    ReportResult("containers", label, totalMs / repeats, size);
+}
+
+static std::vector<u64> RandomKeys(size_t count, u64 seed)
+{
+    std::mt19937_64 random(seed);
+
+    std::vector<u64> keys(count);
+    for (u64& key : keys)
+        key = random();
+
+    return keys;
+}
+
+// Paths like the ones the editor hashes. They are longer than the small string buffer, and the
+// tables move entries with memcpy or realloc, which heap allocated std::strings survive.
+static std::vector<std::string> RandomStringKeys(size_t count, u64 seed)
+{
+    std::mt19937_64 random(seed);
+
+    std::vector<std::string> keys(count);
+    for (std::string& key : keys)
+    {
+        char buffer[64];
+        snprintf(buffer, sizeof(buffer), "sprites/characters/walk_%016llx", (unsigned long long) random());
+        key = buffer;
+    }
+
+    return keys;
+}
+
+// Growing from empty with push_back and emplace_back, then a pass over the values
+template <typename Array>
+static void ArrayWorkload(const char* name, size_t size)
+{
+    size_t repeats = RepeatsFor(size);
+    f64 pushMs = 0.0, emplaceMs = 0.0, iterateMs = 0.0;
+    u64 sum = 0;
+
+    for (size_t r = 0; r < repeats; r++)
+    {
+        {
+            BenchTimer timer;
+            Array array;
+            for (size_t i = 0; i < size; i++)
+                array.push_back(i);
+
+            pushMs += timer.ElapsedMs();
+
+            timer = BenchTimer();
+            for (u64 value : array)
+                sum += value;
+
+            iterateMs += timer.ElapsedMs();
+        }
+
+        {
+            BenchTimer timer;
+            Array array;
+            for (size_t i = 0; i < size; i++)
+                array.emplace_back(i);
+
+            emplaceMs += timer.ElapsedMs();
+            sink += array[size - 1];
+        }
+    }
+
+    char label[64];
+    snprintf(label, sizeof(label), "%s push_back", name);
+    ReportSized(label, size, pushMs, repeats);
+    snprintf(label, sizeof(label), "%s emplace_back", name);
+    ReportSized(label, size, emplaceMs, repeats);
+    snprintf(label, sizeof(label), "%s iterate", name);
+    ReportSized(label, size, iterateMs, repeats);
+
+    BENCH_CHECK(sum == (u64) repeats * size * (size - 1) / 2);
+    sink += sum;
+}
+
+static void CompareArrays()
+{
+    for (size_t size : sweepSizes)
+    {
+        ArrayWorkload<gn::darray<u64>>("gn::darray", size);
+        ArrayWorkload<std::vector<u64>>("std::vector", size);
+    }
+}
+
+// Insert every key, find all of them, miss as many, then erase them all
+template <typename Table, typename Key>
+static void MapWorkload(const char* name, const std::vector<Key>& keys, const std::vector<Key>& misses)
+{
+    size_t repeats = RepeatsFor(keys.size());
+    f64 insertMs = 0.0, hitMs = 0.0, missMs = 0.0, eraseMs = 0.0;
+    size_t hits = 0, falseHits = 0;
+    bool emptied = true;
+
+    for (size_t r = 0; r < repeats; r++)
+    {
+        Table table;
+
+        BenchTimer timer;
+        for (size_t i = 0; i < keys.size(); i++)
+            table[keys[i]] = i;
+
+        insertMs += timer.ElapsedMs();
+
+        timer = BenchTimer();
+        for (const Key& key : keys)
+            hits += table.find(key) != table.end();
+
+        hitMs += timer.ElapsedMs();
+
+        timer = BenchTimer();
+        for (const Key& key : misses)
+            falseHits += table.find(key) != table.end();
+
+        missMs += timer.ElapsedMs();
+
+        timer = BenchTimer();
+        for (const Key& key : keys)
+            table.erase(key);
+
+        eraseMs += timer.ElapsedMs();
+        emptied = emptied && table.size() == 0;
+    }
+
+    char label[64];
+    snprintf(label, sizeof(label), "%s insert", name);
+    ReportSized(label, keys.size(), insertMs, repeats);
+    snprintf(label, sizeof(label), "%s find hit", name);
+    ReportSized(label, keys.size(), hitMs, repeats);
+    snprintf(label, sizeof(label), "%s find miss", name);
+    ReportSized(label, keys.size(), missMs, repeats);
+    snprintf(label, sizeof(label), "%s erase", name);
+    ReportSized(label, keys.size(), eraseMs, repeats);
+
+    BENCH_CHECK(hits == repeats * keys.size());
+    BENCH_CHECK(falseHits == 0);
+    BENCH_CHECK(emptied);
+    sink += hits;
+}
+
+// Probe lengths at the table's fullest, before anything is erased
+template <typename Key>
+static void PrintHashTableStats(const std::vector<Key>& keys)
+{
+    gn::hash_table<Key, u64> table;
+    for (size_t i = 0; i < keys.size(); i++)
+        table[keys[i]] = i;
+
+    gn::table_stats stats = table.stats();
+    printf("  %-40s load %.2f, average probe %.2f, max probe %zu\n", "gn::hash_table stats",
+           stats.load_factor, stats.average_probe, stats.max_probe);
+}
+
+static void CompareMaps()
+{
+    for (size_t size : sweepSizes)
+    {
+        std::vector<u64> keys = RandomKeys(size, 1);
+        std::vector<u64> misses = RandomKeys(size, 2);
+
+        MapWorkload<gn::hash_table<u64, u64>>("gn::hash_table", keys, misses);
+        MapWorkload<gn::ordered_table<u64, u64>>("gn::ordered_table", keys, misses);
+        MapWorkload<std::unordered_map<u64, u64>>("std::unordered_map", keys, misses);
+
+        if (size == sweepSizes[std::size(sweepSizes) - 1])
+            PrintHashTableStats(keys);
+    }
+}
+
+static void CompareStringMaps()
+{
+    for (size_t size : stringSweepSizes)
+    {
+        std::vector<std::string> keys = RandomStringKeys(size, 3);
+        std::vector<std::string> misses = RandomStringKeys(size, 4);
+
+        MapWorkload<gn::hash_table<std::string, u64>>("gn::hash_table string", keys, misses);
+        MapWorkload<gn::ordered_table<std::string, u64>>("gn::ordered_table string", keys, misses);
+        MapWorkload<std::unordered_map<std::string, u64>>("std::unordered_map string", keys, misses);
+
+        if (size == stringSweepSizes[std::size(stringSweepSizes) - 1])
+            PrintHashTableStats(keys);
+    }
+}
+
+// emplace never replaces, a repeated key keeps its first value and its place in the order
+static void CheckDuplicateEmplace()
+{
+    gn::hash_table<u64, u64> table;
+    table.emplace(1, 10);
+    BENCH_CHECK(table.emplace(1, 20) == 10 && table.size() == 1);
+
+    gn::ordered_table<u64, u64> ordered;
+    ordered.emplace(1, 10);
+    ordered.emplace(2, 20);
+    BENCH_CHECK(ordered.emplace(1, 30) == 10 && ordered.size() == 2);
+    BENCH_CHECK((*ordered.begin()).key == 1 && (*ordered.begin()).value == 10);
+}
+
+// Same shape as the text layout cache: a fixed number of live keys, the oldest erased for every new one.
+// Erases leave tombstones behind, the table has to reclaim them without growing or running out of slots.
+static void HashTableChurn()
+{
+    constexpr u64 liveCount = 256;
+    constexpr u64 distinctCount = 200000;
+
+    gn::hash_table<u64, u32> table;
+    size_t maxCapacity = 0;
+    bool allFound = true;
+
+    BenchTimer timer;
+    for (u64 i = 0; i < distinctCount; i++)
+    {
+        u64 key = i * 0x9E3779B97F4A7C15ull;
+
+        if (i >= liveCount)
+            table.erase((i - liveCount) * 0x9E3779B97F4A7C15ull);
+
+        table[key] = (u32) i;
+        allFound = allFound && table.find(key) != table.end();
+        maxCapacity = std::max(maxCapacity, table.capacity());
+    }
+
+    ReportResult("containers", "gn::hash_table lru churn", timer.ElapsedMs(), distinctCount);
+
+    BENCH_CHECK(allFound);
+    BENCH_CHECK(table.size() == liveCount);
+    BENCH_CHECK(maxCapacity <= 4 * liveCount);
+
+    u64 evicted = (distinctCount - liveCount - 1) * 0x9E3779B97F4A7C15ull;
+    BENCH_CHECK(table.find(evicted) == table.end());
+
+    for (u64 i = distinctCount - liveCount; i < distinctCount; i++)
+        BENCH_CHECK(table[i * 0x9E3779B97F4A7C15ull] == (u32) i);
+
+    table.clear();
+    BENCH_CHECK(table.size() == 0 && table.begin() == table.end());
+}
+
+// Handles against plain indices into a vector, which is what the slot map replaced
+static void CompareSlotMap()
+{
+    std::vector<u32> order(slotMapCount);
+    for (u32 i = 0; i < slotMapCount; i++)
+        order[i] = i;
+
+    std::shuffle(order.begin(), order.end(), std::mt19937(3));
+
+    {
+        gn::slot_map<u64> map;
+        std::vector<gn::slot_handle> handles(slotMapCount);
+
+        BenchTimer timer;
+        for (size_t i = 0; i < slotMapCount; i++)
+            handles[i] = map.emplace(i);
+
+        ReportResult("containers", "gn::slot_map emplace", timer.ElapsedMs(), slotMapCount);
+
+        timer = BenchTimer();
+        u64 sum = 0;
+        for (u32 i : order)
+            sum += *map.find(handles[i]);
+
+        ReportResult("containers", "gn::slot_map random lookup", timer.ElapsedMs(), slotMapCount);
+
+        timer = BenchTimer();
+        for (u32 i : order)
+            map.erase(handles[i]);
+
+        ReportResult("containers", "gn::slot_map erase", timer.ElapsedMs(), slotMapCount);
+
+        BENCH_CHECK(sum == (u64) slotMapCount * (slotMapCount - 1) / 2);
+        BENCH_CHECK(map.size() == 0);
+        BENCH_CHECK(map.find(handles[0]) == nullptr);
+        sink += sum;
+    }
+
+    {
+        std::vector<u64> array;
+
+        BenchTimer timer;
+        for (size_t i = 0; i < slotMapCount; i++)
+            array.push_back(i);
+
+        ReportResult("containers", "std::vector index push_back", timer.ElapsedMs(), slotMapCount);
+
+        timer = BenchTimer();
+        u64 sum = 0;
+        for (u32 i : order)
+            sum += array[i];
+
+        ReportResult("containers", "std::vector random lookup", timer.ElapsedMs(), slotMapCount);
+        sink += sum;
+    }
+}
+
+void RunContainerBench()
+{
+    CompareArrays();
+    CompareMaps();
+    CompareStringMaps();
+    CheckDuplicateEmplace();
+    HashTableChurn();
+    CompareSlotMap();
+
+    BENCH_CHECK(sink != 0);
+}
@@ -0,0 +1,107 @@
+#include "bench.h"
+
+#include <algorithm>
+#include <bitset>
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include "containers/common_hashes.h"
+#include "math/basic_types.h"
+#include "math/hash.h"
+
+static constexpr size_t capacities[] = { 64, 256, 1024, 4096 };     // Powers of 2 are the worst case for hash % capacity
+static constexpr size_t keysPerBucket = 8;
+
+// Chi squared of the bucket counts divided by the bucket count. Close to 1 for a uniform spread,
+// keys that pile into a few buckets push it far higher.
+static f64 BucketSpread(const std::vector<u64>& hashes, size_t capacity)
+{
+    std::vector<u64> counts(capacity, 0);
+    for (u64 hash : hashes)
+        counts[hash % capacity]++;
+
+    f64 expected = (f64) hashes.size() / capacity;
+    f64 chiSquared = 0.0;
+
+    for (u64 count : counts)
+        chiSquared += (count - expected) * (count - expected) / expected;
+
+    return chiSquared / capacity;
+}
+
+template <typename MakeHash>
+static void CheckSpread(const char* name, MakeHash makeHash)
+{
+    for (size_t capacity : capacities)
+    {
+        std::vector<u64> hashes;
+        for (size_t i = 0; i < capacity * keysPerBucket; i++)
+            hashes.push_back(makeHash(i));
+
+        f64 spread = BucketSpread(hashes, capacity);
+        if (!BENCH_CHECK(spread < 1.5))
+            printf("    %s, capacity %zu: spread %.2f\n", name, capacity, spread);
+
+        // No full width collisions either
+        std::unordered_set<u64> unique(hashes.begin(), hashes.end());
+        BENCH_CHECK(unique.size() == hashes.size());
+    }
+}
+
+// Flipping any input bit should flip about half the output bits
+static void CheckAvalanche()
+{
+    u64 flipped = 0, samples = 0;
+
+    for (u64 key = 0; key < 4096; key++)
+    {
+        u64 hash = gn::hash_u64(key);
+        for (u32 bit = 0; bit < 64; bit++)
+        {
+            flipped += std::bitset<64>(hash ^ gn::hash_u64(key ^ (1ull << bit))).count();
+            samples++;
+        }
+    }
+
+    f64 average = (f64) flipped / samples;
+    if (!BENCH_CHECK(average > 31.0 && average < 33.0))
+        printf("    hash_u64 avalanche: %.2f bits\n", average);
+}
+
+void RunHashBench()
+{
+    CheckSpread("small integers", [](size_t i) { return (u64) gn::hash<u64>()(i); });
+    CheckSpread("negative integers", [](size_t i) { return (u64) gn::hash<s32>()(-(s32) i); });
+    CheckSpread("multiples of 4096", [](size_t i) { return (u64) gn::hash<u64>()(i * 4096); });
+
+    // Frame corners snapped to a 32 pixel grid, packed the way IRect coordinates would be
+    CheckSpread("packed 32px grid", [](size_t i) { return (u64) gn::hash<u64>()(((u64) (i % 128) * 32 << 32) | (i / 128) * 32); });
+
+    CheckSpread("Vector2 on a 16px grid", [](size_t i)
+    {
+        return (u64) gn::hash<Vector2>()(Vector2((f32) (i % 100) * 16.0f, (f32) (i / 100) * 16.0f));
+    });
+
+    CheckSpread("frame names", [](size_t i) { return (u64) gn::hash<std::string>()("Frame " + std::to_string(i)); });
+    CheckSpread("hash_combine", [](size_t i) { return gn::hash_combine(i / 64, i % 64); });
+
+    CheckAvalanche();
+
+    const u64 count = 10000000;
+    u64 sink = 0;
+
+    BenchTimer timer;
+    for (u64 i = 0; i < count; i++)
+        sink += gn::hash_u64(i);
+
+    ReportResult("hashes", "hash_u64", timer.ElapsedMs(), count);
+
+    std::string text = "Loop:\tPing Pong";
+    timer = BenchTimer();
+    for (u64 i = 0; i < count; i++)
+        sink += gn::hash_bytes(text.data(), text.length(), i);
+
+    ReportResult("hashes", "hash_bytes 15 bytes", timer.ElapsedMs(), count);
+
+    BENCH_CHECK(sink != 0);     // Keeps the loops from being optimized out
+}
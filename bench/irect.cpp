@@ -0,0 +1,165 @@
+#include "bench.h"
+
+#include <random>
+#include <vector>
+#include "math/basic_types.h"
+#include "math/cpu.h"
+#include "math/irect.h"
+
+// An IRect inside a bigger struct so the stride isn't just sizeof(IRect)
+struct FrameLike
+{
+    IRect rect;
+    f32   duration;
+};
+
+// Mostly regular rects, with zero and negative sizes mixed in since the SSE4.1 paths
+// detect empty rects differently from IRect::Empty()
+static std::vector<FrameLike> RandomFrames(size_t count, u32 seed)
+{
+    std::mt19937 random(seed);
+    std::uniform_int_distribution<s32> position(-4096, 4096);
+    std::uniform_int_distribution<s32> size(1, 512);
+    std::uniform_int_distribution<s32> kind(0, 9);
+
+    std::vector<FrameLike> frames(count);
+    for (FrameLike& frame : frames)
+    {
+        IRect& rect = frame.rect;
+        rect = IRect(position(random), position(random), size(random), size(random));
+
+        switch (kind(random))
+        {
+            case 0: rect.width = 0; break;
+            case 1: rect.height = 0; break;
+            case 2: rect.width = -rect.width; break;
+            case 3: rect.height = -rect.height; break;
+            default: break;
+        }
+    }
+
+    return frames;
+}
+
+// The scalar paths are these loops over the single rect functions, so the dispatched
+// results are compared against them directly
+static void CheckAgainstScalar(const std::vector<FrameLike>& frames, size_t count, const IRect& query)
+{
+    const IRect* rects = &frames[0].rect;
+    const size_t stride = sizeof(FrameLike);
+
+    IRect expectedUnion;
+    for (size_t i = 0; i < count; i++)
+        expectedUnion = Union(expectedUnion, frames[i].rect);
+
+    BENCH_CHECK(UnionRects(rects, stride, count) == expectedUnion);
+
+    std::vector<u8> mask(count + 1, 0xCD);
+    OverlapMask(rects, stride, count, query, mask.data());
+
+    bool maskMatches = true;
+    s64 expectedFirst = -1;
+    for (size_t i = 0; i < count; i++)
+    {
+        bool overlaps = Overlaps(frames[i].rect, query);
+        maskMatches = maskMatches && mask[i] == (u8) overlaps;
+
+        if (overlaps && expectedFirst < 0)
+            expectedFirst = (s64) i;
+    }
+
+    BENCH_CHECK(maskMatches);
+    BENCH_CHECK(mask[count] == 0xCD);
+    BENCH_CHECK(FindFirstOverlap(rects, stride, count, query) == expectedFirst);
+
+    std::vector<FrameLike> clipped(frames.begin(), frames.begin() + count);
+    if (count > 0)
+        ClipRects(&clipped[0].rect, stride, count, query);
+
+    bool clipMatches = true;
+    for (size_t i = 0; i < count; i++)
+        clipMatches = clipMatches && clipped[i].rect == Intersect(frames[i].rect, query) &&
+                      clipped[i].duration == frames[i].duration;
+
+    BENCH_CHECK(clipMatches);
+}
+
+void RunIRectBench()
+{
+    printf("  sse41 %d\n", GetCpuFeatures().sse41);
+
+    std::vector<FrameLike> frames = RandomFrames(100000, 5);
+
+    const IRect queries[] = {
+        IRect(-200, -300, 1000, 800),
+        IRect(17, 23, 1, 1),            // Pixel hit test
+        IRect(0, 0, 0, 64),             // Zero size
+        IRect(0, 0, 64, 0),
+        IRect(500, 500, -100, 200),     // Inverted
+        IRect(-5000, -5000, 10000, 10000),
+    };
+
+    const size_t counts[] = { 0, 1, 2, 3, 17, frames.size() };
+
+    for (const IRect& query : queries)
+    {
+        for (size_t count : counts)
+            CheckAgainstScalar(frames, count, query);
+    }
+
+    // Nothing but empty rects
+    std::vector<FrameLike> empty(8);
+    for (size_t i = 0; i < empty.size(); i++)
+        empty[i].rect = IRect((s32) i, (s32) i, -(s32) i, (s32) (i % 2));
+
+    BENCH_CHECK(UnionRects(&empty[0].rect, sizeof(FrameLike), empty.size()) == IRect());
+    BENCH_CHECK(FindFirstOverlap(&empty[0].rect, sizeof(FrameLike), empty.size(), queries[5]) == -1);
+
+    // A hit test that misses everything has to scan every rect
+    const IRect miss(100000, 100000, 1, 1);
+    const IRect* rects = &frames[0].rect;
+    const size_t stride = sizeof(FrameLike);
+    const u64 repeats = 100;
+    s64 sink = 0;
+
+    BenchTimer timer;
+    for (u64 i = 0; i < repeats; i++)
+    {
+        for (size_t j = 0; j < frames.size(); j++)
+        {
+            if (Overlaps(frames[j].rect, miss))
+            {
+                sink += j;
+                break;
+            }
+        }
+    }
+
+    ReportResult("irect", "FindFirstOverlap scalar, 100k rects", timer.ElapsedMs() / repeats, frames.size());
+
+    timer = BenchTimer();
+    for (u64 i = 0; i < repeats; i++)
+        sink += FindFirstOverlap(rects, stride, frames.size(), miss);
+
+    ReportResult("irect", "FindFirstOverlap dispatched, 100k rects", timer.ElapsedMs() / repeats, frames.size());
+
+    timer = BenchTimer();
+    IRect bounds;
+    for (u64 i = 0; i < repeats; i++)
+    {
+        bounds = IRect();
+        for (size_t j = 0; j < frames.size(); j++)
+            bounds = Union(bounds, frames[j].rect);
+    }
+
+    ReportResult("irect", "UnionRects scalar, 100k rects", timer.ElapsedMs() / repeats, frames.size());
+
+    timer = BenchTimer();
+    for (u64 i = 0; i < repeats; i++)
+        sink += UnionRects(rects, stride, frames.size()).width;
+
+    ReportResult("irect", "UnionRects dispatched, 100k rects", timer.ElapsedMs() / repeats, frames.size());
+
+    BENCH_CHECK(UnionRects(rects, stride, frames.size()) == bounds);
+    BENCH_CHECK(sink != 0);
+}
@@ -0,0 +1,135 @@
+#include "bench.h"
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "math/basic_types.h"
+
+struct Suite
+{
+    const char* name;
+    void (*run)();
+};
+
+static const Suite suites[] = {
+    { "queues", RunQueueBench },
+    { "hashes", RunHashBench },
+    { "concurrent_table", RunConcurrentTableBench },
+    { "bitset", RunBitsetBench },
+    { "containers", RunContainerBench },
+    { "batch", RunBatchBench },
+    { "irect", RunIRectBench },
+    { "soa_darray", RunSoaDarrayBench },
+    { "persistent_vector", RunPersistentVectorBench },
+};
+
+struct Result
+{
+    std::string suite, name;
+    f64 ms;
+    u64 ops;
+    f64 nsPerOp;
+};
+
+static std::vector<Result> results;
+static s32 failures = 0;
+
+bool BenchCheck(bool passed, const char* expression, const char* file, int line)
+{
+    if (!passed)
+    {
+        printf("%s(%d) Check failed: %s\n", file, line, expression);
+        failures++;
+    }
+
+    return passed;
+}
+
+void ReportResult(const char* suite, const char* name, f64 ms, u64 ops)
+{
+    f64 nsPerOp = (ops > 0) ? (ms * 1000000.0 / ops) : 0.0;
+    printf("  %-40s %10.2f ms %10.2f ns/op\n", name, ms, nsPerOp);
+
+    results.push_back(Result { suite, name, ms, ops, nsPerOp });
+}
+
+// Names are plain ASCII without quotes or commas, nothing needs escaping
+static bool WriteJson(const char* path)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+        return false;
+
+    fprintf(file, "[\n");
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const Result& result = results[i];
+        fprintf(file, "  { \"suite\": \"%s\", \"name\": \"%s\", \"ms\": %.4f, \"ops\": %llu, \"ns_per_op\": %.4f }%s\n",
+                result.suite.c_str(), result.name.c_str(), result.ms, (unsigned long long) result.ops, result.nsPerOp,
+                (i + 1 < results.size()) ? "," : "");
+    }
+    fprintf(file, "]\n");
+
+    fclose(file);
+    return true;
+}
+
+static bool WriteCsv(const char* path)
+{
+    FILE* file = fopen(path, "wb");
+    if (!file)
+        return false;
+
+    fprintf(file, "suite,name,ms,ops,ns_per_op\n");
+    for (const Result& result : results)
+    {
+        fprintf(file, "%s,%s,%.4f,%llu,%.4f\n", result.suite.c_str(), result.name.c_str(),
+                result.ms, (unsigned long long) result.ops, result.nsPerOp);
+    }
+
+    fclose(file);
+    return true;
+}
+
+// bench [--json file] [--csv file] [suite...], runs every suite when none are named
+int main(int argc, char** argv)
+{
+    const char* jsonPath = nullptr;
+    const char* csvPath = nullptr;
+    std::vector<const char*> selected;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            jsonPath = argv[++i];
+        else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+            csvPath = argv[++i];
+        else
+            selected.push_back(argv[i]);
+    }
+
+    for (const Suite& suite : suites)
+    {
+        bool run = selected.empty();
+        for (const char* name : selected)
+            run = run || strcmp(name, suite.name) == 0;
+
+        if (!run)
+            continue;
+
+        printf("%s\n", suite.name);
+        suite.run();
+    }
+
+    if (jsonPath && !WriteJson(jsonPath))
+        printf("Couldn't write %s\n", jsonPath);
+
+    if (csvPath && !WriteCsv(csvPath))
+        printf("Couldn't write %s\n", csvPath);
+
+    if (failures > 0)
+        printf("%d checks failed\n", failures);
+
+    return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,160 @@
+#include "bench.h"
+
+#include <vector>
+#include "containers/persistent_vector.h"
+#include "math/basic_types.h"
+
+// Counts live values so copied leaves and released snapshots can be checked exactly
+struct Tracked
+{
+    static s64 live;
+    s64 value;
+
+    Tracked(s64 value = 0) : value(value) { live++; }
+    Tracked(const Tracked& other) : value(other.value) { live++; }
+    Tracked& operator=(const Tracked& other) = default;
+    ~Tracked() { live--; }
+};
+
+s64 Tracked::live = 0;
+
+struct alignas(64) OverAligned
+{
+    s32 value;
+};
+
+static constexpr size_t width = gn::persistent_vector<s32>::WIDTH;
+
+static void CheckSnapshots()
+{
+    {
+        const size_t count = 100 * width;
+
+        gn::persistent_vector<Tracked> current;
+        for (size_t i = 0; i < count; i++)
+            current.push_back(Tracked((s64) i));
+
+        BENCH_CHECK(Tracked::live == (s64) count);
+
+        // Each snapshot is taken before one edit, the edit only copies the leaf it touches
+        std::vector<gn::persistent_vector<Tracked>> history;
+        for (size_t edit = 0; edit < 50; edit++)
+        {
+            history.push_back(current);
+            BENCH_CHECK(history.back().shares_root_with(current));
+
+            current.set(edit * width, Tracked(-1));
+        }
+
+        BENCH_CHECK(Tracked::live == (s64) (count + 50 * width));
+
+        bool unchanged = true;
+        for (size_t version = 0; version < history.size(); version++)
+        {
+            const gn::persistent_vector<Tracked>& snapshot = history[version];
+
+            for (size_t edit = 0; edit < 50; edit++)
+            {
+                s64 expected = (edit < version) ? -1 : (s64) (edit * width);
+                unchanged = unchanged && snapshot[edit * width].value == expected;
+            }
+
+            unchanged = unchanged && snapshot[count - 1].value == (s64) (count - 1);
+        }
+        BENCH_CHECK(unchanged);
+
+        bool edited = true;
+        for (size_t edit = 0; edit < 50; edit++)
+            edited = edited && current[edit * width].value == -1 && current[edit * width + 1].value == (s64) (edit * width + 1);
+        BENCH_CHECK(edited);
+
+        // Edits to a snapshot don't reach the vector it was taken from, or the other snapshots
+        history[0].edit(5).value = 1234;
+        BENCH_CHECK(history[0][5].value == 1234);
+        BENCH_CHECK(history[1][5].value == 5 && current[5].value == 5);
+
+        // Growing past a full tree adds a level without touching older versions
+        gn::persistent_vector<Tracked> grown = current;
+        for (size_t i = 0; i < width * width; i++)
+            grown.push_back(Tracked(7));
+
+        BENCH_CHECK(grown.size() == count + width * width && current.size() == count);
+        BENCH_CHECK(grown[count].value == 7 && grown[0].value == -1);
+
+        grown.pop_back();
+        BENCH_CHECK(grown.size() == count + width * width - 1 && current[count - 1].value == (s64) (count - 1));
+
+        // Dropping history releases everything only it referenced
+        history.clear();
+        grown.clear();
+        BENCH_CHECK(Tracked::live == (s64) count);
+    }
+
+    BENCH_CHECK(Tracked::live == 0);
+}
+
+static void CheckAlignment()
+{
+    gn::persistent_vector<OverAligned> values;
+    for (s32 i = 0; i < 1000; i++)
+        values.push_back(OverAligned { i });
+
+    gn::persistent_vector<OverAligned> snapshot = values;
+    values.set(500, OverAligned { -1 });
+
+    bool aligned = true;
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        aligned = aligned && ((uintptr_t) &values[i] % alignof(OverAligned)) == 0;
+        aligned = aligned && ((uintptr_t) &snapshot[i] % alignof(OverAligned)) == 0;
+    }
+
+    BENCH_CHECK(aligned);
+    BENCH_CHECK(snapshot[500].value == 500 && values[500].value == -1);
+}
+
+// Snapshot plus one edit per step, the undo history pattern, against copying the whole array
+static void TimeHistory()
+{
+    const size_t count = 1000000;
+    const size_t steps = 1000;
+
+    gn::persistent_vector<s32> current;
+    std::vector<s32> flat;
+    for (size_t i = 0; i < count; i++)
+    {
+        current.push_back((s32) i);
+        flat.push_back((s32) i);
+    }
+
+    std::vector<gn::persistent_vector<s32>> history;
+    history.reserve(steps);
+
+    BenchTimer timer;
+    for (size_t step = 0; step < steps; step++)
+    {
+        history.push_back(current);
+        current.set((step * 7919) % count, -1);
+    }
+    ReportResult("persistent_vector", "snapshot + edit, 1M values", timer.ElapsedMs(), steps);
+
+    std::vector<std::vector<s32>> copies;
+    copies.reserve(100);
+
+    timer = BenchTimer();
+    for (size_t step = 0; step < 100; step++)
+    {
+        copies.push_back(flat);
+        flat[(step * 7919) % count] = -1;
+    }
+    ReportResult("persistent_vector", "std::vector copy + edit, 1M values", timer.ElapsedMs(), 100);
+
+    BENCH_CHECK(history[0][0] == 0 && current[0] == -1);
+}
+
+void RunPersistentVectorBench()
+{
+    CheckSnapshots();
+    CheckAlignment();
+    TimeHistory();
+}
@@ -0,0 +1,144 @@
+#include "bench.h"
+
+#include <thread>
+#include <vector>
+#include "containers/mpmc_queue.h"
+#include "containers/spsc_queue.h"
+#include "math/basic_types.h"
+
+static constexpr u64 spscCount = 10000000;
+static constexpr u64 mpmcPerProducer = 1000000;
+static constexpr s32 mpmcThreads = 4;      // Producers, and as many consumers
+
+// Values carry the producer in the top bits and its sequence number in the rest
+static constexpr u64 sequenceBits = 40;
+static constexpr u64 sequenceMask = (1ull << sequenceBits) - 1;
+
+static void SpscStress()
+{
+    gn::spsc_queue<u64> queue(1024);
+
+    BenchTimer timer;
+
+    std::thread producer([&queue]()
+    {
+        for (u64 i = 0; i < spscCount; i++)
+        {
+            while (!queue.try_push(i))
+                std::this_thread::yield();
+        }
+    });
+
+    // Has to see every value exactly once and in order
+    bool inOrder = true;
+    for (u64 expected = 0; expected < spscCount; expected++)
+    {
+        u64 value;
+        while (!queue.try_pop(value))
+            std::this_thread::yield();
+
+        inOrder = inOrder && value == expected;
+    }
+
+    producer.join();
+
+    ReportResult("queues", "spsc_queue 1 producer 1 consumer", timer.ElapsedMs(), spscCount);
+
+    u64 leftover;
+    BENCH_CHECK(inOrder);
+    BENCH_CHECK(!queue.try_pop(leftover));
+}
+
+static void MpmcStress()
+{
+    gn::mpmc_queue<u64> queue(1024);
+
+    const u64 total = mpmcPerProducer * mpmcThreads;
+    std::atomic<u64> popped { 0 };
+
+    // Per consumer, the last sequence seen from each producer and a count of values per producer
+    std::vector<std::vector<s64>> lastSeen(mpmcThreads, std::vector<s64>(mpmcThreads, -1));
+    std::vector<std::vector<u64>> received(mpmcThreads, std::vector<u64>(mpmcThreads, 0));
+    std::vector<u64> sums(mpmcThreads, 0);
+    std::vector<u8> ordered(mpmcThreads, 1);
+
+    BenchTimer timer;
+
+    std::vector<std::thread> threads;
+    for (s32 p = 0; p < mpmcThreads; p++)
+    {
+        threads.emplace_back([&queue, p]()
+        {
+            for (u64 i = 0; i < mpmcPerProducer; i++)
+            {
+                u64 value = ((u64) p << sequenceBits) | i;
+                while (!queue.try_push(value))
+                    std::this_thread::yield();
+            }
+        });
+    }
+
+    for (s32 c = 0; c < mpmcThreads; c++)
+    {
+        threads.emplace_back([&, c]()
+        {
+            while (popped.load(std::memory_order_relaxed) < total)
+            {
+                u64 value;
+                if (!queue.try_pop(value))
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+
+                popped.fetch_add(1, std::memory_order_relaxed);
+
+                u64 producer = value >> sequenceBits;
+                s64 sequence = (s64) (value & sequenceMask);
+
+                // One producer's values reach any single consumer in the order they were pushed
+                if (sequence <= lastSeen[c][producer])
+                    ordered[c] = 0;
+
+                lastSeen[c][producer] = sequence;
+                received[c][producer]++;
+                sums[c] += value & sequenceMask;
+            }
+        });
+    }
+
+    for (std::thread& thread : threads)
+        thread.join();
+
+    ReportResult("queues", "mpmc_queue 4 producers 4 consumers", timer.ElapsedMs(), total);
+
+    // Nothing lost or duplicated: every producer's count and sequence sum add up
+    u64 expectedSum = mpmcPerProducer * (mpmcPerProducer - 1) / 2 * mpmcThreads;
+    u64 sum = 0;
+
+    for (s32 p = 0; p < mpmcThreads; p++)
+    {
+        u64 count = 0;
+        for (s32 c = 0; c < mpmcThreads; c++)
+            count += received[c][p];
+
+        BENCH_CHECK(count == mpmcPerProducer);
+    }
+
+    for (s32 c = 0; c < mpmcThreads; c++)
+    {
+        sum += sums[c];
+        BENCH_CHECK(ordered[c]);
+    }
+
+    u64 leftover;
+    BENCH_CHECK(sum == expectedSum);
+    BENCH_CHECK(popped.load() == total);
+    BENCH_CHECK(!queue.try_pop(leftover));
+}
+
+void RunQueueBench()
+{
+    SpscStress();
+    MpmcStress();
+}
@@ -0,0 +1,172 @@
+#include "bench.h"
+
+#include <string>
+#include <vector>
+#include "containers/slot_map.h"
+#include "containers/soa_darray.h"
+#include "math/basic_types.h"
+#include "math/irect.h"
+#include "math/vecs/vector2.h"
+
+// Counts live instances so leaks and double destroys show up
+struct Counted
+{
+    static s64 live;
+    s32 value;
+
+    Counted(s32 value = 0) : value(value) { live++; }
+    Counted(const Counted& other) : value(other.value) { live++; }
+    Counted& operator=(const Counted& other) = default;
+    ~Counted() { live--; }
+};
+
+s64 Counted::live = 0;
+
+template <typename T>
+static bool Aligned(const T* pointer)
+{
+    return ((uintptr_t) pointer % SOA_DARRAY_ALIGNMENT) == 0;
+}
+
+static void CheckArray()
+{
+    {
+        gn::soa_darray<s32, std::string, Counted> rows;
+        for (s32 i = 0; i < 1000; i++)
+            rows.push_back(i, std::to_string(i), Counted(i * 2));
+
+        BENCH_CHECK(rows.size() == 1000);
+        BENCH_CHECK(Aligned(rows.field<0>()) && Aligned(rows.field<1>()) && Aligned(rows.field<2>()));
+        BENCH_CHECK(Counted::live == 1000);
+
+        bool matches = true;
+        for (s32 i = 0; i < 1000; i++)
+        {
+            auto [number, text, counted] = rows[i];
+            matches = matches && number == i && text == std::to_string(i) && counted.value == i * 2;
+        }
+        BENCH_CHECK(matches);
+
+        // Order is kept by erase_at, erase_swap moves the last row into the hole
+        rows.erase_at(0);
+        BENCH_CHECK(rows.field<0>()[0] == 1 && rows.field<1>()[998] == "999");
+
+        rows.erase_swap(0);
+        BENCH_CHECK(rows.field<0>()[0] == 999 && rows.field<1>()[0] == "999" && rows.size() == 998);
+        BENCH_CHECK(Counted::live == 998);
+
+        // Copies don't share buffers
+        gn::soa_darray<s32, std::string, Counted> copy = rows;
+        std::get<1>(copy[0]) = "changed";
+        BENCH_CHECK(rows.field<1>()[0] == "999");
+        BENCH_CHECK(Counted::live == 2 * 998);
+
+        gn::soa_darray<s32, std::string, Counted> moved = std::move(copy);
+        BENCH_CHECK(copy.size() == 0 && moved.size() == 998 && moved.field<1>()[0] == "changed");
+
+        moved.resize(10);
+        BENCH_CHECK(moved.size() == 10 && Counted::live == 998 + 10);
+
+        moved.resize(20);
+        BENCH_CHECK(std::get<0>(moved[19]) == 0 && std::get<1>(moved[19]).empty());
+
+        s32 sum = 0;
+        for (auto [number, text, counted] : rows)
+            sum += number - counted.value / 2;
+        BENCH_CHECK(sum == 0);
+    }
+
+    BENCH_CHECK(Counted::live == 0);
+}
+
+// Same handles as slot_map over a darray, the fields come back as references
+static void CheckSlotMap()
+{
+    gn::soa_slot_map<IRect, Vector2> frames;
+    std::vector<gn::slot_handle> handles;
+
+    for (s32 i = 0; i < 100; i++)
+        handles.push_back(frames.emplace(IRect(i, 0, 1, 1), Vector2((f32) i)));
+
+    frames.erase(handles[10]);
+    frames.erase_ordered(handles[50]);
+
+    BENCH_CHECK(frames.size() == 98);
+    BENCH_CHECK(!frames.contains(handles[10]) && !frames.contains(handles[50]));
+
+    bool matches = true;
+    for (s32 i = 0; i < 100; i++)
+    {
+        if (i == 10 || i == 50)
+            continue;
+
+        auto [rect, pivot] = frames[handles[i]];
+        matches = matches && rect.x == i && pivot.x == (f32) i;
+    }
+    BENCH_CHECK(matches);
+
+    // Writes through the row land in the field arrays
+    auto [rect, pivot] = frames[handles[0]];
+    rect.width = 42;
+    pivot.y = 3.0f;
+    BENCH_CHECK(frames.dense().field<0>()[frames.index_of(handles[0])].width == 42);
+
+    gn::soa_slot_map<IRect, Vector2> copy = frames;
+    std::get<0>(copy[handles[0]]).width = 7;
+    BENCH_CHECK(std::get<0>(frames[handles[0]]).width == 42);
+    BENCH_CHECK(copy.size() == frames.size() && std::get<0>(copy[handles[99]]).x == 99);
+
+    // Freed slots are reused with a new generation
+    gn::slot_handle reused = frames.emplace(IRect(), Vector2());
+    BENCH_CHECK(reused.index == handles[50].index && reused != handles[50]);
+}
+
+struct FrameRow
+{
+    IRect   rect;
+    Vector2 pivot;
+};
+
+// Summing every rect's x, the case the layout is for
+static void TimeFieldScan()
+{
+    const size_t count = 1000000;
+    const u64 repeats = 20;
+
+    gn::soa_darray<IRect, Vector2> columns(count);
+    std::vector<FrameRow> rows(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        columns.push_back(IRect((s32) i, 0, 1, 1), Vector2());
+        rows[i].rect = IRect((s32) i, 0, 1, 1);
+    }
+
+    s64 soaSum = 0, aosSum = 0;
+
+    BenchTimer timer;
+    for (u64 r = 0; r < repeats; r++)
+    {
+        const IRect* rects = columns.field<0>();
+        for (size_t i = 0; i < count; i++)
+            soaSum += rects[i].x;
+    }
+    ReportResult("soa_darray", "sum rect.x, soa_darray", timer.ElapsedMs() / repeats, count);
+
+    timer = BenchTimer();
+    for (u64 r = 0; r < repeats; r++)
+    {
+        for (size_t i = 0; i < count; i++)
+            aosSum += rows[i].rect.x;
+    }
+    ReportResult("soa_darray", "sum rect.x, array of structs", timer.ElapsedMs() / repeats, count);
+
+    BENCH_CHECK(soaSum == aosSum);
+}
+
+void RunSoaDarrayBench()
+{
+    CheckArray();
+    CheckSlotMap();
+    TimeFieldScan();
+}
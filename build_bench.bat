@@ -0,0 +1,14 @@
+@echo off
+
+rem Checks and timings for the containers and math kernels, separate from the editor
+
+set includes= /I src
+
+set sources= bench\*.cpp src\math\batch.cpp src\math\cpu.cpp src\math\hash.cpp src\math\irect.cpp
+
+set compile_flags=/O2 /EHsc /std:c++17 /DNDEBUG /MP7
+
+rem bench [--json file] [--csv file] [suite...]
+cl %compile_flags% %sources% %includes% /Fe:bench.exe
+
+del *.obj
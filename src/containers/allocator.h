@@ -0,0 +1,327 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include "math/basic_types.h"
+#include "misc/gn_assert.h"
+
+#define ALLOCATOR_DEFAULT_ALIGNMENT 16
+
+namespace gn {
+
+// Allocators are small copyable handles passed to containers as a template parameter.
+// Every call receives the size of the block so allocators don't need to store headers.
+// A null pointer passed to reallocate() behaves like allocate().
+
+struct heap_allocator
+{
+    void* allocate(size_t bytes)
+    {
+        return malloc(bytes);
+    }
+
+    void* reallocate(void* ptr, size_t /* old_bytes */, size_t new_bytes)
+    {
+        return realloc(ptr, new_bytes);
+    }
+
+    void deallocate(void* ptr, size_t /* bytes */)
+    {
+        free(ptr);
+    }
+};
+
+// Linear memory block. Individual allocations are never freed,
+// everything is released at once with reset().
+struct arena
+{
+    u8* buffer = nullptr;
+    size_t capacity = 0;
+    size_t used = 0;
+    size_t last_offset = 0;     // Start of the most recent allocation, allows growing it in place
+
+    void init(size_t bytes)
+    {
+        buffer = (u8*) malloc(bytes);
+        ASSERT(buffer);
+
+        capacity = bytes;
+        used = last_offset = 0;
+    }
+
+    void* push(size_t bytes)
+    {
+        size_t offset = (used + ALLOCATOR_DEFAULT_ALIGNMENT - 1) & ~(size_t) (ALLOCATOR_DEFAULT_ALIGNMENT - 1);
+        if (offset + bytes > capacity)
+        {
+            ASSERT_NOT_VALID("arena::push() ran out of memory");
+            return nullptr;
+        }
+
+        last_offset = offset;
+        used = offset + bytes;
+        return buffer + offset;
+    }
+
+    void reset()
+    {
+        used = last_offset = 0;
+    }
+
+    void free()
+    {
+        ::free(buffer);
+        buffer = nullptr;
+        capacity = used = last_offset = 0;
+    }
+};
+
+struct arena_allocator
+{
+    arena* source = nullptr;
+
+    arena_allocator() = default;
+    arena_allocator(arena& source)
+    :   source(&source) {}
+
+    void* allocate(size_t bytes)
+    {
+        ASSERT(source);
+        return source->push(bytes);
+    }
+
+    void* reallocate(void* ptr, size_t old_bytes, size_t new_bytes)
+    {
+        ASSERT(source);
+
+        if (ptr == nullptr)
+            return source->push(new_bytes);
+
+        // The most recent allocation can grow or shrink in place
+        if ((u8*) ptr == source->buffer + source->last_offset &&
+            source->last_offset + new_bytes <= source->capacity)
+        {
+            source->used = source->last_offset + new_bytes;
+            return ptr;
+        }
+
+        if (new_bytes <= old_bytes)
+            return ptr;
+
+        void* new_ptr = source->push(new_bytes);
+        if (new_ptr)
+            memcpy(new_ptr, ptr, old_bytes);
+
+        return new_ptr;
+    }
+
+    void deallocate(void* ptr, size_t /* bytes */)
+    {
+        if (ptr == nullptr)
+            return;
+
+        ASSERT(source);
+
+        // Only the most recent allocation can be given back
+        if ((u8*) ptr == source->buffer + source->last_offset)
+            source->used = source->last_offset;
+    }
+};
+
+// Fixed size blocks with an intrusive free list. Blocks are carved out
+// of chunks that are only returned to the OS when the pool is freed.
+struct pool
+{
+    struct chunk_t
+    {
+        chunk_t* next;
+    };
+
+    size_t block_size = 0;
+    size_t blocks_per_chunk = 0;
+    void* free_list = nullptr;
+    chunk_t* chunks = nullptr;
+
+    void init(size_t block_bytes, size_t blocks_per_chunk_count = 64)
+    {
+        block_size = (block_bytes + ALLOCATOR_DEFAULT_ALIGNMENT - 1) & ~(size_t) (ALLOCATOR_DEFAULT_ALIGNMENT - 1);
+        blocks_per_chunk = blocks_per_chunk_count;
+        free_list = nullptr;
+        chunks = nullptr;
+    }
+
+    void* take()
+    {
+        if (free_list == nullptr)
+            add_chunk();
+
+        void* block = free_list;
+        free_list = *(void**) block;
+        return block;
+    }
+
+    void give_back(void* block)
+    {
+        *(void**) block = free_list;
+        free_list = block;
+    }
+
+    void free()
+    {
+        while (chunks)
+        {
+            chunk_t* next = chunks->next;
+            ::free(chunks);
+            chunks = next;
+        }
+
+        free_list = nullptr;
+    }
+
+private:
+    void add_chunk()
+    {
+        // Header is padded to the alignment so blocks stay aligned
+        size_t header = (sizeof(chunk_t) + ALLOCATOR_DEFAULT_ALIGNMENT - 1) & ~(size_t) (ALLOCATOR_DEFAULT_ALIGNMENT - 1);
+
+        chunk_t* chunk = (chunk_t*) malloc(header + block_size * blocks_per_chunk);
+        ASSERT(chunk);
+
+        chunk->next = chunks;
+        chunks = chunk;
+
+        u8* blocks = (u8*) chunk + header;
+        for (size_t i = 0; i < blocks_per_chunk; i++)
+            give_back(blocks + i * block_size);
+    }
+};
+
+// Requests that don't fit in a block fall back to the heap
+struct pool_allocator
+{
+    pool* source = nullptr;
+
+    pool_allocator() = default;
+    pool_allocator(pool& source)
+    :   source(&source) {}
+
+    void* allocate(size_t bytes)
+    {
+        ASSERT(source);
+
+        if (bytes <= source->block_size)
+            return source->take();
+
+        return malloc(bytes);
+    }
+
+    void* reallocate(void* ptr, size_t old_bytes, size_t new_bytes)
+    {
+        if (ptr == nullptr)
+            return allocate(new_bytes);
+
+        ASSERT(source);
+
+        bool was_pooled = old_bytes <= source->block_size;
+        bool is_pooled  = new_bytes <= source->block_size;
+
+        if (was_pooled && is_pooled)
+            return ptr;
+
+        if (!was_pooled && !is_pooled)
+            return realloc(ptr, new_bytes);
+
+        void* new_ptr = allocate(new_bytes);
+        memcpy(new_ptr, ptr, (old_bytes < new_bytes) ? old_bytes : new_bytes);
+        deallocate(ptr, old_bytes);
+
+        return new_ptr;
+    }
+
+    void deallocate(void* ptr, size_t bytes)
+    {
+        if (ptr == nullptr)
+            return;
+
+        ASSERT(source);
+
+        if (bytes <= source->block_size)
+            source->give_back(ptr);
+        else
+            ::free(ptr);
+    }
+};
+
+struct allocation_stats
+{
+    size_t allocations = 0;
+    size_t reallocations = 0;
+    size_t deallocations = 0;
+    size_t bytes_in_use = 0;
+    size_t peak_bytes_in_use = 0;
+};
+
+// Forwards to another allocator while keeping count in a shared stats block,
+// use one stats block per subsystem to see where memory goes.
+template <typename base_allocator_t = heap_allocator>
+struct counting_allocator
+{
+    allocation_stats* stats = nullptr;
+    base_allocator_t base;
+
+    counting_allocator() = default;
+    counting_allocator(allocation_stats& stats, const base_allocator_t& base = base_allocator_t())
+    :   stats(&stats), base(base) {}
+
+    void* allocate(size_t bytes)
+    {
+        if (stats)
+        {
+            stats->allocations++;
+            add_bytes(bytes);
+        }
+
+        return base.allocate(bytes);
+    }
+
+    void* reallocate(void* ptr, size_t old_bytes, size_t new_bytes)
+    {
+        if (stats)
+        {
+            if (ptr)
+            {
+                stats->reallocations++;
+                stats->bytes_in_use -= old_bytes;
+            }
+            else
+            {
+                stats->allocations++;
+            }
+
+            add_bytes(new_bytes);
+        }
+
+        return base.reallocate(ptr, old_bytes, new_bytes);
+    }
+
+    void deallocate(void* ptr, size_t bytes)
+    {
+        if (stats && ptr)
+        {
+            stats->deallocations++;
+            stats->bytes_in_use -= bytes;
+        }
+
+        base.deallocate(ptr, bytes);
+    }
+
+private:
+    void add_bytes(size_t bytes)
+    {
+        stats->bytes_in_use += bytes;
+        if (stats->bytes_in_use > stats->peak_bytes_in_use)
+            stats->peak_bytes_in_use = stats->bytes_in_use;
+    }
+};
+
+} // namespace gn
\ No newline at end of file
@@ -0,0 +1,241 @@
+#pragma once
+
+#include <cstring>
+#include "bitset.h"
+#include "math/basic_types.h"
+#include "misc/gn_assert.h"
+
+namespace gn {
+
+// One bit per cell, row major. Every row starts on its own aligned block of words
+// so row queries never straddle two rows and whole rows can be scanned with AVX2.
+// Rectangles are given as x, y, width, height in cells.
+class bitmap2d
+{
+public:
+    u32 width() const { return _width; }
+    u32 height() const { return _height; }
+    size_t words_per_row() const { return _words_per_row; }
+
+    const u64* row(u32 y) const { ASSERT(y < _height); return _words + y * _words_per_row; }
+          u64* row(u32 y)       { ASSERT(y < _height); return _words + y * _words_per_row; }
+
+    // All bits start out unset
+    void init(u32 width, u32 height)
+    {
+        _width = width;
+        _height = height;
+        _words_per_row = bits_words_for(width);
+        _words = bits_allocate(_words_per_row * height);
+    }
+
+    // Sets the bit for every element whose byte at the given offset is non zero.
+    // For RGBA8 pixels, stride 4 and offset 3 marks every pixel that isn't fully transparent.
+    void set_from_bytes(const u8* bytes, u32 byte_stride, u32 byte_offset = 0)
+    {
+        for (u32 y = 0; y < _height; y++)
+        {
+            u64* words = row(y);
+            const u8* src = bytes + (size_t) y * _width * byte_stride + byte_offset;
+
+            for (u32 x = 0; x < _width; x++)
+            {
+                if (src[(size_t) x * byte_stride])
+                    words[x / 64] |= 1ull << (x % 64);
+            }
+        }
+    }
+
+    void set_all()
+    {
+        fill_rect(0, 0, _width, _height);
+    }
+
+    bool test(u32 x, u32 y) const
+    {
+        ASSERT(x < _width);
+        return (row(y)[x / 64] >> (x % 64)) & 1;
+    }
+
+    void set(u32 x, u32 y)
+    {
+        ASSERT(x < _width);
+        row(y)[x / 64] |= 1ull << (x % 64);
+    }
+
+    void reset(u32 x, u32 y)
+    {
+        ASSERT(x < _width);
+        row(y)[x / 64] &= ~(1ull << (x % 64));
+    }
+
+    void fill_rect(u32 x, u32 y, u32 w, u32 h)
+    {
+        ASSERT(x + w <= _width && y + h <= _height);
+
+        for (u32 r = y; r < y + h; r++)
+            bits_set_range(row(r), x, x + w);
+    }
+
+    void clear_rect(u32 x, u32 y, u32 w, u32 h)
+    {
+        ASSERT(x + w <= _width && y + h <= _height);
+
+        for (u32 r = y; r < y + h; r++)
+            bits_reset_range(row(r), x, x + w);
+    }
+
+    void clear()
+    {
+        if (_words)
+            memset(_words, 0, _words_per_row * _height * sizeof(u64));
+    }
+
+    bool any_in_rect(u32 x, u32 y, u32 w, u32 h) const
+    {
+        ASSERT(x + w <= _width && y + h <= _height);
+
+        for (u32 r = y; r < y + h; r++)
+        {
+            if (bits_any_in_range(row(r), x, x + w))
+                return true;
+        }
+
+        return false;
+    }
+
+    bool all_in_rect(u32 x, u32 y, u32 w, u32 h) const
+    {
+        ASSERT(x + w <= _width && y + h <= _height);
+
+        for (u32 r = y; r < y + h; r++)
+        {
+            if (!bits_all_in_range(row(r), x, x + w))
+                return false;
+        }
+
+        return true;
+    }
+
+    size_t count_in_rect(u32 x, u32 y, u32 w, u32 h) const
+    {
+        ASSERT(x + w <= _width && y + h <= _height);
+
+        size_t count = 0;
+        for (u32 r = y; r < y + h; r++)
+            count += bits_count_range(row(r), x, x + w);
+
+        return count;
+    }
+
+    size_t count() const
+    {
+        return bits_count_words(_words, _words_per_row * _height);
+    }
+
+    bool row_empty(u32 y) const
+    {
+        return !bits_any_words(row(y), _words_per_row);
+    }
+
+    bool any_in_row(u32 y, u32 x_begin, u32 x_end) const
+    {
+        ASSERT(x_end <= _width);
+        return bits_any_in_range(row(y), x_begin, x_end);
+    }
+
+    // Checks a single column between rows [y_begin, y_end)
+    bool any_in_column(u32 x, u32 y_begin, u32 y_end) const
+    {
+        ASSERT(x < _width && y_end <= _height);
+
+        size_t word = x / 64;
+        u64 bit = 1ull << (x % 64);
+
+        for (u32 y = y_begin; y < y_end; y++)
+        {
+            if (_words[y * _words_per_row + word] & bit)
+                return true;
+        }
+
+        return false;
+    }
+
+    // First set bit in the row at or after x, -1 if there is none
+    s64 find_first_set_in_row(u32 y, u32 x = 0) const
+    {
+        return bits_find_first_set(row(y), x, _width);
+    }
+
+    s64 find_first_unset_in_row(u32 y, u32 x = 0) const
+    {
+        return bits_find_first_unset(row(y), x, _width);
+    }
+
+    // Constructors and Destructors
+
+    bitmap2d(u32 width = 0, u32 height = 0)
+    {
+        init(width, height);
+    }
+
+    bitmap2d(const bitmap2d& other)
+    {
+        init(other._width, other._height);
+        if (_words)
+            memcpy(_words, other._words, _words_per_row * _height * sizeof(u64));
+    }
+
+    bitmap2d(bitmap2d&& other)
+    :   _words(other._words), _words_per_row(other._words_per_row),
+        _width(other._width), _height(other._height)
+    {
+        other._words = nullptr;
+        other._words_per_row = 0;
+        other._width = other._height = 0;
+    }
+
+    ~bitmap2d()
+    {
+        bits_free(_words);
+    }
+
+    bitmap2d& operator=(const bitmap2d& other)
+    {
+        if (this == &other)
+            return *this;
+
+        bits_free(_words);
+        init(other._width, other._height);
+        if (_words)
+            memcpy(_words, other._words, _words_per_row * _height * sizeof(u64));
+
+        return *this;
+    }
+
+    bitmap2d& operator=(bitmap2d&& other)
+    {
+        if (this == &other)
+            return *this;
+
+        bits_free(_words);
+
+        _words = other._words;
+        _words_per_row = other._words_per_row;
+        _width = other._width;
+        _height = other._height;
+
+        other._words = nullptr;
+        other._words_per_row = 0;
+        other._width = other._height = 0;
+
+        return *this;
+    }
+
+private:
+    u64* _words = nullptr;
+    size_t _words_per_row = 0;
+    u32 _width = 0, _height = 0;
+};
+
+} // namespace gn
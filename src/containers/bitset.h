@@ -0,0 +1,456 @@
+#pragma once
+
+#include <cstdlib>
+#include <cstring>
+#include <immintrin.h>
+#include "math/basic_types.h"
+#include "math/cpu.h"
+#include "misc/gn_assert.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#define BITSET_ALIGNMENT        32      // One AVX2 register
+#define BITSET_WORDS_PER_BLOCK  4       // u64 words per AVX2 register
+
+namespace gn {
+
+// Word level helpers shared by bitset and bitmap2d.
+// Bit i lives in words[i / 64] at position i % 64, ranges are half open [begin, end).
+// Buffers are always padded to whole blocks of 4 words with the padding kept at 0,
+// so the AVX2 paths never need a scalar tail. Those are picked at runtime through cpu.h.
+
+// Used by the scalar paths, which run on CPUs without POPCNT. MSVC's __popcnt64 always emits
+// the instruction so it gets the bit trick instead, GCC and Clang only emit it when targeting it.
+inline u32 bits_popcount(u64 word)
+{
+#   if defined(_MSC_VER)
+    word = word - ((word >> 1) & 0x5555555555555555ull);
+    word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+    word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+    return (u32) ((word * 0x0101010101010101ull) >> 56);
+#   else
+    return (u32) __builtin_popcountll(word);
+#   endif
+}
+
+// word must not be 0
+inline u32 bits_lowest_set(u64 word)
+{
+#   if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (u32) index;
+#   else
+    return (u32) __builtin_ctzll(word);
+#   endif
+}
+
+inline size_t bits_words_for(size_t bit_count)
+{
+    size_t words = (bit_count + 63) / 64;
+    return (words + BITSET_WORDS_PER_BLOCK - 1) & ~(size_t) (BITSET_WORDS_PER_BLOCK - 1);
+}
+
+inline u64* bits_allocate(size_t word_count)
+{
+    if (word_count == 0)
+        return nullptr;
+
+#   ifdef _MSC_VER
+    u64* words = (u64*) _aligned_malloc(word_count * sizeof(u64), BITSET_ALIGNMENT);
+#   else
+    u64* words = (u64*) aligned_alloc(BITSET_ALIGNMENT, word_count * sizeof(u64));
+#   endif
+
+    ASSERT(words);
+    memset(words, 0, word_count * sizeof(u64));
+    return words;
+}
+
+inline void bits_free(u64* words)
+{
+#   ifdef _MSC_VER
+    _aligned_free(words);
+#   else
+    free(words);
+#   endif
+}
+
+// Mask of the bits of word w that fall inside [begin, end)
+inline u64 bits_range_mask(size_t w, size_t begin, size_t end)
+{
+    u64 mask = ~0ull;
+
+    if (w == begin / 64)
+        mask &= ~0ull << (begin % 64);
+
+    if (w == (end - 1) / 64)
+        mask &= ~0ull >> (63 - (end - 1) % 64);
+
+    return mask;
+}
+
+inline void bits_set_range(u64* words, size_t begin, size_t end)
+{
+    if (begin >= end)
+        return;
+
+    size_t first = begin / 64, last = (end - 1) / 64;
+
+    words[first] |= bits_range_mask(first, begin, end);
+    for (size_t w = first + 1; w < last; w++)
+        words[w] = ~0ull;
+
+    if (last != first)
+        words[last] |= bits_range_mask(last, begin, end);
+}
+
+inline void bits_reset_range(u64* words, size_t begin, size_t end)
+{
+    if (begin >= end)
+        return;
+
+    size_t first = begin / 64, last = (end - 1) / 64;
+
+    words[first] &= ~bits_range_mask(first, begin, end);
+    for (size_t w = first + 1; w < last; w++)
+        words[w] = 0;
+
+    if (last != first)
+        words[last] &= ~bits_range_mask(last, begin, end);
+}
+
+inline bool bits_any_in_range(const u64* words, size_t begin, size_t end)
+{
+    if (begin >= end)
+        return false;
+
+    size_t first = begin / 64, last = (end - 1) / 64;
+
+    if (words[first] & bits_range_mask(first, begin, end))
+        return true;
+
+    for (size_t w = first + 1; w < last; w++)
+    {
+        if (words[w])
+            return true;
+    }
+
+    return last != first && (words[last] & bits_range_mask(last, begin, end));
+}
+
+inline bool bits_all_in_range(const u64* words, size_t begin, size_t end)
+{
+    if (begin >= end)
+        return true;
+
+    size_t first = begin / 64, last = (end - 1) / 64;
+
+    u64 mask = bits_range_mask(first, begin, end);
+    if ((words[first] & mask) != mask)
+        return false;
+
+    for (size_t w = first + 1; w < last; w++)
+    {
+        if (words[w] != ~0ull)
+            return false;
+    }
+
+    mask = bits_range_mask(last, begin, end);
+    return last == first || (words[last] & mask) == mask;
+}
+
+inline size_t bits_count_range(const u64* words, size_t begin, size_t end)
+{
+    if (begin >= end)
+        return 0;
+
+    size_t first = begin / 64, last = (end - 1) / 64;
+
+    size_t count = bits_popcount(words[first] & bits_range_mask(first, begin, end));
+    for (size_t w = first + 1; w < last; w++)
+        count += bits_popcount(words[w]);
+
+    if (last != first)
+        count += bits_popcount(words[last] & bits_range_mask(last, begin, end));
+
+    return count;
+}
+
+inline size_t bits_count_words_scalar(const u64* words, size_t word_count)
+{
+    size_t count = 0;
+    for (size_t w = 0; w < word_count; w++)
+        count += bits_popcount(words[w]);
+
+    return count;
+}
+
+GN_TARGET_AVX2_FMA
+inline size_t bits_count_words_avx2(const u64* words, size_t word_count)
+{
+    // Nibble lookup popcount (Mula, Kurz, Lemire), bytes are summed with sad_epu8
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low_mask = _mm256_set1_epi8(0x0f);
+    __m256i total = _mm256_setzero_si256();
+
+    for (size_t w = 0; w < word_count; w += BITSET_WORDS_PER_BLOCK)
+    {
+        __m256i v  = _mm256_load_si256((const __m256i*) (words + w));
+        __m256i lo = _mm256_and_si256(v, low_mask);
+        __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo),
+                                         _mm256_shuffle_epi8(lookup, hi));
+
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+
+    return (size_t) (_mm256_extract_epi64(total, 0) + _mm256_extract_epi64(total, 1) +
+                     _mm256_extract_epi64(total, 2) + _mm256_extract_epi64(total, 3));
+}
+
+// Population count of whole blocks, word_count must be a multiple of 4
+inline size_t bits_count_words(const u64* words, size_t word_count)
+{
+    static const auto impl = GetCpuFeatures().avx2 ? bits_count_words_avx2 : bits_count_words_scalar;
+    return impl(words, word_count);
+}
+
+inline bool bits_any_words_scalar(const u64* words, size_t word_count)
+{
+    for (size_t w = 0; w < word_count; w++)
+    {
+        if (words[w])
+            return true;
+    }
+
+    return false;
+}
+
+GN_TARGET_AVX2_FMA
+inline bool bits_any_words_avx2(const u64* words, size_t word_count)
+{
+    for (size_t w = 0; w < word_count; w += BITSET_WORDS_PER_BLOCK)
+    {
+        __m256i v = _mm256_load_si256((const __m256i*) (words + w));
+        if (!_mm256_testz_si256(v, v))
+            return true;
+    }
+
+    return false;
+}
+
+// True if any bit is set in whole blocks, word_count must be a multiple of 4
+inline bool bits_any_words(const u64* words, size_t word_count)
+{
+    static const auto impl = GetCpuFeatures().avx2 ? bits_any_words_avx2 : bits_any_words_scalar;
+    return impl(words, word_count);
+}
+
+// Index of the first set bit in [begin, end), -1 if there is none
+inline s64 bits_find_first_set(const u64* words, size_t begin, size_t end)
+{
+    if (begin >= end)
+        return -1;
+
+    size_t first = begin / 64, last = (end - 1) / 64;
+
+    for (size_t w = first; w <= last; w++)
+    {
+        u64 word = words[w] & bits_range_mask(w, begin, end);
+        if (word)
+            return (s64) (w * 64 + bits_lowest_set(word));
+    }
+
+    return -1;
+}
+
+// Index of the first unset bit in [begin, end), -1 if there is none
+inline s64 bits_find_first_unset(const u64* words, size_t begin, size_t end)
+{
+    if (begin >= end)
+        return -1;
+
+    size_t first = begin / 64, last = (end - 1) / 64;
+
+    for (size_t w = first; w <= last; w++)
+    {
+        u64 word = ~words[w] & bits_range_mask(w, begin, end);
+        if (word)
+            return (s64) (w * 64 + bits_lowest_set(word));
+    }
+
+    return -1;
+}
+
+// Fixed size set of bits, sized at runtime
+class bitset
+{
+public:
+    size_t size() const { return _size; }
+    size_t word_count() const { return _word_count; }
+
+    const u64* words() const { return _words; }
+          u64* words()       { return _words; }
+
+    // All bits start out unset
+    void init(size_t bit_count)
+    {
+        _size = bit_count;
+        _word_count = bits_words_for(bit_count);
+        _words = bits_allocate(_word_count);
+    }
+
+    bool test(size_t index) const
+    {
+        ASSERT(index < _size);
+        return (_words[index / 64] >> (index % 64)) & 1;
+    }
+
+    void set(size_t index)
+    {
+        ASSERT(index < _size);
+        _words[index / 64] |= 1ull << (index % 64);
+    }
+
+    void reset(size_t index)
+    {
+        ASSERT(index < _size);
+        _words[index / 64] &= ~(1ull << (index % 64));
+    }
+
+    void assign(size_t index, bool value)
+    {
+        if (value)
+            set(index);
+        else
+            reset(index);
+    }
+
+    void set_range(size_t begin, size_t end)
+    {
+        ASSERT(end <= _size);
+        bits_set_range(_words, begin, end);
+    }
+
+    void reset_range(size_t begin, size_t end)
+    {
+        ASSERT(end <= _size);
+        bits_reset_range(_words, begin, end);
+    }
+
+    void set_all()
+    {
+        bits_set_range(_words, 0, _size);
+    }
+
+    void reset_all()
+    {
+        if (_words)
+            memset(_words, 0, _word_count * sizeof(u64));
+    }
+
+    bool any() const { return bits_any_words(_words, _word_count); }
+    bool none() const { return !any(); }
+
+    size_t count() const { return bits_count_words(_words, _word_count); }
+
+    bool any_in_range(size_t begin, size_t end) const
+    {
+        ASSERT(end <= _size);
+        return bits_any_in_range(_words, begin, end);
+    }
+
+    bool all_in_range(size_t begin, size_t end) const
+    {
+        ASSERT(end <= _size);
+        return bits_all_in_range(_words, begin, end);
+    }
+
+    size_t count_range(size_t begin, size_t end) const
+    {
+        ASSERT(end <= _size);
+        return bits_count_range(_words, begin, end);
+    }
+
+    s64 find_first_set(size_t from = 0) const
+    {
+        return bits_find_first_set(_words, from, _size);
+    }
+
+    s64 find_first_unset(size_t from = 0) const
+    {
+        return bits_find_first_unset(_words, from, _size);
+    }
+
+    bool operator[](size_t index) const
+    {
+        return test(index);
+    }
+
+    // Constructors and Destructors
+
+    bitset(size_t bit_count = 0)
+    {
+        init(bit_count);
+    }
+
+    bitset(const bitset& other)
+    {
+        init(other._size);
+        if (_words)
+            memcpy(_words, other._words, _word_count * sizeof(u64));
+    }
+
+    bitset(bitset&& other)
+    :   _words(other._words), _size(other._size), _word_count(other._word_count)
+    {
+        other._words = nullptr;
+        other._size = other._word_count = 0;
+    }
+
+    ~bitset()
+    {
+        bits_free(_words);
+    }
+
+    bitset& operator=(const bitset& other)
+    {
+        if (this == &other)
+            return *this;
+
+        bits_free(_words);
+        init(other._size);
+        if (_words)
+            memcpy(_words, other._words, _word_count * sizeof(u64));
+
+        return *this;
+    }
+
+    bitset& operator=(bitset&& other)
+    {
+        if (this == &other)
+            return *this;
+
+        bits_free(_words);
+
+        _words = other._words;
+        _size = other._size;
+        _word_count = other._word_count;
+
+        other._words = nullptr;
+        other._size = other._word_count = 0;
+
+        return *this;
+    }
+
+private:
+    u64* _words = nullptr;
+    size_t _size = 0;
+    size_t _word_count = 0;
+};
+
+} // namespace gn
@@ -1,26 +1,154 @@
 #pragma once
 
+#include <cstring>
+#include <string>
+#include <string_view>
 #include "hash_table.h"
 #include "math/basic_types.h"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 namespace gn
 {
 
+// Mixing functions based on wyhash (final version 4, public domain).
+// A 64x64 -> 128 bit multiply folded back to 64 bits spreads every input bit
+// over the whole result, so keys that only differ in a few bits (grid aligned
+// coordinates, small integers) still land far apart with hash % capacity.
+
+static constexpr u64 hash_secret[4] = {
+    0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+    0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+};
+
+inline void hash_multiply(u64& a, u64& b)
+{
+#   ifdef _MSC_VER
+    a = _umul128(a, b, &b);
+#   else
+    __uint128_t r = (__uint128_t) a * b;
+    a = (u64) r;
+    b = (u64) (r >> 64);
+#   endif
+}
+
+inline u64 hash_mix(u64 a, u64 b)
+{
+    hash_multiply(a, b);
+    return a ^ b;
+}
+
+inline u64 hash_u64(u64 key)
+{
+    u64 a = key ^ hash_secret[0];
+    u64 b = key ^ hash_secret[1];
+    hash_multiply(a, b);
+    return hash_mix(a ^ hash_secret[0], b ^ hash_secret[1]);
+}
+
+// Use to hash multiple values into one, start with seed = 0
+inline u64 hash_combine(u64 seed, u64 value)
+{
+    return hash_mix(seed ^ hash_secret[0], value ^ hash_secret[1]);
+}
+
+inline u64 hash_f32_bits(f32 key)
+{
+    // +0.0f and -0.0f compare equal so they need to hash equal too
+    if (key == 0.0f)
+        key = 0.0f;
+
+    u32 bits;
+    memcpy(&bits, &key, sizeof(bits));
+    return bits;
+}
+
+inline u64 hash_bytes(const void* data, size_t length, u64 seed = 0)
+{
+    auto read8 = [](const u8* p) { u64 v; memcpy(&v, p, 8); return v; };
+    auto read4 = [](const u8* p) { u32 v; memcpy(&v, p, 4); return (u64) v; };
+
+    const u8* p = (const u8*) data;
+    seed ^= hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+
+    u64 a, b;
+
+    if (length <= 16)
+    {
+        if (length >= 4)
+        {
+            a = (read4(p) << 32) | read4(p + ((length >> 3) << 2));
+            b = (read4(p + length - 4) << 32) | read4(p + length - 4 - ((length >> 3) << 2));
+        }
+        else if (length > 0)
+        {
+            a = ((u64) p[0] << 16) | ((u64) p[length >> 1] << 8) | p[length - 1];
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        size_t i = length;
+
+        if (i > 48)
+        {
+            u64 seed1 = seed, seed2 = seed;
+
+            do
+            {
+                seed  = hash_mix(read8(p)      ^ hash_secret[1], read8(p + 8)  ^ seed);
+                seed1 = hash_mix(read8(p + 16) ^ hash_secret[2], read8(p + 24) ^ seed1);
+                seed2 = hash_mix(read8(p + 32) ^ hash_secret[3], read8(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+
+            seed ^= seed1 ^ seed2;
+        }
+
+        while (i > 16)
+        {
+            seed = hash_mix(read8(p) ^ hash_secret[1], read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+
+        a = read8(p + i - 16);
+        b = read8(p + i - 8);
+    }
+
+    a ^= hash_secret[1];
+    b ^= seed;
+    hash_multiply(a, b);
+
+    return hash_mix(a ^ hash_secret[0] ^ length, b ^ hash_secret[1]);
+}
+
 template <>
 struct hash<f32>
 {
     size_t operator()(f32 const& key) const
     {
-        u8* bytes = (u8*) &key;
-        u8 h[4];
+        return hash_u64(hash_f32_bits(key));
+    }
+};
 
-        h[0] = bytes[3];
-        h[1] = bytes[2];
-        h[2] = bytes[1];
-        h[3] = bytes[0];
+template <>
+struct hash<f64>
+{
+    size_t operator()(f64 const& key) const
+    {
+        f64 value = (key == 0.0) ? 0.0 : key;
 
-        u32 hash = *(u32*)h;
-        return hash;
+        u64 bits;
+        memcpy(&bits, &value, sizeof(bits));
+        return hash_u64(bits);
     }
 };
 
@@ -29,7 +157,52 @@ struct hash<u64>
 {
     size_t operator()(u64 const& key) const
     {
-        return key;
+        return hash_u64(key);
+    }
+};
+
+template <>
+struct hash<s64>
+{
+    size_t operator()(s64 const& key) const
+    {
+        return hash_u64((u64) key);
+    }
+};
+
+template <>
+struct hash<u32>
+{
+    size_t operator()(u32 const& key) const
+    {
+        return hash_u64(key);
+    }
+};
+
+template <>
+struct hash<s32>
+{
+    size_t operator()(s32 const& key) const
+    {
+        return hash_u64((u64) (u32) key);
+    }
+};
+
+template <>
+struct hash<std::string_view>
+{
+    size_t operator()(std::string_view const& key) const
+    {
+        return hash_bytes(key.data(), key.length());
+    }
+};
+
+template <>
+struct hash<std::string>
+{
+    size_t operator()(std::string const& key) const
+    {
+        return hash_bytes(key.data(), key.length());
     }
 };
 
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <mutex>
+#include <utility>
+#include "hash_table.h"
+#include "ordered_table.h"
+#include "math/basic_types.h"
+
+#define CONCURRENT_TABLE_SHARD_BITS 6
+
+namespace gn {
+
+// Hash map that can be shared between threads, split into independently locked shards.
+// The top bits of the hash pick the shard and the shard's own table uses the low bits,
+// so threads working on different keys rarely wait on each other.
+// Values are returned by copy since a reference would outlive the shard lock,
+// keep values small (indices, handles) and store the real data elsewhere.
+template <typename key_t, typename value_t, typename hasher = hash<key_t>, u32 shard_bits = CONCURRENT_TABLE_SHARD_BITS>
+class concurrent_table
+{
+public:
+    static constexpr u32 SHARD_COUNT = 1 << shard_bits;
+
+    struct insert_result
+    {
+        value_t value;      // Value stored in the table after the call
+        bool    inserted;   // False if another thread got there first
+    };
+
+    // Stores the value if the key is missing, otherwise returns the value already there.
+    // Handy for dedupe: the first thread to see a content hash wins.
+    insert_result insert_or_get(const key_t& key, const value_t& value)
+    {
+        shard_t& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.table.find(key);
+        if (it != shard.table.end())
+            return insert_result { (*it).value, false };
+
+        shard.table.emplace(key, value);
+        return insert_result { value, true };
+    }
+
+    // Inserts or overwrites
+    void set(const key_t& key, const value_t& value)
+    {
+        shard_t& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        shard.table[key] = value;
+    }
+
+    bool find(const key_t& key, value_t& out_value) const
+    {
+        const shard_t& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.table.find(key);
+        if (it == shard.table.end())
+            return false;
+
+        out_value = (*it).value;
+        return true;
+    }
+
+    bool contains(const key_t& key) const
+    {
+        const shard_t& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        return shard.table.find(key) != shard.table.end();
+    }
+
+    void erase(const key_t& key)
+    {
+        shard_t& shard = shard_for(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        shard.table.erase(key);
+    }
+
+    // Only exact while no other thread is writing
+    size_t size() const
+    {
+        size_t total = 0;
+
+        for (u32 i = 0; i < SHARD_COUNT; i++)
+        {
+            std::lock_guard<std::mutex> lock(_shards[i].mutex);
+            total += _shards[i].table.size();
+        }
+
+        return total;
+    }
+
+    void clear()
+    {
+        for (u32 i = 0; i < SHARD_COUNT; i++)
+        {
+            std::lock_guard<std::mutex> lock(_shards[i].mutex);
+            _shards[i].table.clear();
+        }
+    }
+
+    // Visits every pair one shard at a time, the callback must not touch this table.
+    // Order is stable within a shard but not across shards.
+    template <typename Fn>
+    void for_each(Fn&& fn) const
+    {
+        for (u32 i = 0; i < SHARD_COUNT; i++)
+        {
+            std::lock_guard<std::mutex> lock(_shards[i].mutex);
+
+            for (auto it = _shards[i].table.begin(); it != _shards[i].table.end(); ++it)
+                fn((*it).key, (*it).value);
+        }
+    }
+
+    // Constructors and Destructors
+
+    concurrent_table() = default;
+
+    concurrent_table(const concurrent_table&) = delete;
+    concurrent_table& operator=(const concurrent_table&) = delete;
+
+private:
+    // Padded to a cache line so locking one shard doesn't invalidate its neighbours
+    struct alignas(64) shard_t
+    {
+        mutable std::mutex mutex;
+        ordered_table<key_t, value_t, hasher> table;
+    };
+
+    shard_t& shard_for(const key_t& key)
+    {
+        return _shards[shard_index(key)];
+    }
+
+    const shard_t& shard_for(const key_t& key) const
+    {
+        return _shards[shard_index(key)];
+    }
+
+    u32 shard_index(const key_t& key) const
+    {
+        if constexpr (shard_bits == 0)
+            return 0;
+        else
+            return (u32) (hash(key) >> (sizeof(hash_t) * 8 - shard_bits));
+    }
+
+private:
+    shard_t _shards[SHARD_COUNT];
+    hasher hash;
+};
+
+} // namespace gn
@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <initializer_list>
+#include "allocator.h"
 #include "misc/gn_assert.h"
 
 #define DARRAY_START_CAPACITY   2
@@ -9,7 +10,7 @@
 
 namespace gn {
 
-template<typename T>
+template<typename T, typename allocator_t = heap_allocator>
 class darray
 {
 public:
@@ -21,11 +22,12 @@ public:
     const T* data() const { return buffer; };
           T* data()       { return buffer; };
 
-    void init(size_t capacity = DARRAY_START_CAPACITY)
+    void init(size_t capacity = DARRAY_START_CAPACITY, const allocator_t& allocator = allocator_t())
     {
         _size = 0;
-        _capacity = capacity;
+        _capacity = 0;
         buffer = nullptr;
+        _allocator = allocator;
         reallocate(capacity);
     }
 
@@ -70,7 +72,7 @@ public:
         return buffer[_size++];
     }
 
-    T& pop_back()
+    void pop_back()
     {
         if (_size > 0)
         {
@@ -139,16 +141,16 @@ public:
 
     // Constructors and Destructors
 
-    darray(size_t capacity = DARRAY_START_CAPACITY)
-    :   _size(0), _capacity(capacity),
-        buffer(nullptr)
+    darray(size_t capacity = DARRAY_START_CAPACITY, const allocator_t& allocator = allocator_t())
+    :   _size(0), _capacity(0),
+        buffer(nullptr), _allocator(allocator)
     {
         reallocate(capacity);
     }
 
-    darray(std::initializer_list<T> values)
-    :   _size(0), _capacity(values.size()),
-        buffer(nullptr)
+    darray(std::initializer_list<T> values, const allocator_t& allocator = allocator_t())
+    :   _size(0), _capacity(0),
+        buffer(nullptr), _allocator(allocator)
     {
         reallocate(values.size());
         for (auto&& val : values)
@@ -157,7 +159,7 @@ public:
 
     darray(const darray& other)
     :   _size(0), _capacity(0),
-        buffer(nullptr)
+        buffer(nullptr), _allocator(other._allocator)
     {
         reallocate(other._capacity);
 
@@ -167,7 +169,7 @@ public:
 
     darray(darray&& other)
     :   _size(other._size), _capacity(other._capacity),
-        buffer(other.buffer)
+        buffer(other.buffer), _allocator(other._allocator)
     {
         other._size = other._capacity = 0;
         other.buffer = nullptr;
@@ -176,7 +178,7 @@ public:
     ~darray()
     {
         clear();
-        free(buffer);
+        _allocator.deallocate(buffer, _capacity * sizeof(T));
     }
 
     const T& operator[](size_t index) const
@@ -204,9 +206,16 @@ public:
 
     darray& operator=(darray&& other)
     {
+        if (this == &other)
+            return *this;
+
+        clear();
+        _allocator.deallocate(buffer, _capacity * sizeof(T));
+
         buffer = other.buffer;
         _size  = other._size;
         _capacity = other._capacity;
+        _allocator = other._allocator;
 
         other._size = other._capacity = 0;
         other.buffer = nullptr;
@@ -219,7 +228,7 @@ private:
     {
         ASSERT(_size <= new_cap);
 
-        T* new_buffer = (T*) realloc(buffer, new_cap * sizeof(T));
+        T* new_buffer = (T*) _allocator.reallocate(buffer, _capacity * sizeof(T), new_cap * sizeof(T));
         ASSERT(new_buffer);
 
         buffer = new_buffer;
@@ -229,6 +238,7 @@ private:
 private:
     size_t _size = 0, _capacity = 0;
     T* buffer = nullptr;
+    allocator_t _allocator;
 };
 
 } // namespace gn
\ No newline at end of file
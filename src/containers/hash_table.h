@@ -1,5 +1,8 @@
 #pragma once
 
+#include <algorithm>
+#include "allocator.h"
+#include "math/basic_types.h"
 #include "misc/gn_assert.h"
 
 #define HASH_TABLE_MAX_LOAD_FACTOR 0.8
@@ -15,7 +18,18 @@ struct hash
     hash_t operator()(T const& key) const;
 };
 
-template <typename key_t, typename value_t, typename hasher = hash<key_t>>
+// Snapshot of how well a table is laid out, probe lengths are counted from the home slot.
+// Cheap enough to log from debug builds to track hash quality over time.
+struct table_stats
+{
+    size_t size = 0;
+    size_t capacity = 0;
+    f64    load_factor = 0.0;
+    f64    average_probe = 0.0;
+    size_t max_probe = 0;
+};
+
+template <typename key_t, typename value_t, typename hasher = hash<key_t>, typename allocator_t = heap_allocator>
 class hash_table
 {
 public:
@@ -57,8 +71,8 @@ public:
 
             index++;
 
-            while (table->_table[index].state != state_t::ACTIVE &&
-                   index <= table->_last)
+            while (index <= table->_last &&
+                   table->_table[index].state != state_t::ACTIVE)
             { index++; }
         }
 
@@ -101,7 +115,19 @@ public:
     size_t size() const { return _size; }
     size_t capacity() const { return _capacity; }
 
-    iterator begin() const { return iterator(this, _first); }
+    // Erases don't move _first, so it can point at a slot that is no longer active
+    iterator begin() const
+    {
+        if (_size == 0)
+            return end();
+
+        iterator it(this, _first);
+        if (_table[_first].state != state_t::ACTIVE)
+            it.advance();
+
+        return it;
+    }
+
     iterator end() const { return iterator(this, _last + 1); }
 
     void resize(size_t new_cap)
@@ -114,6 +140,7 @@ public:
 
         _first = new_cap;
         _last = 0;
+        _tombstones = 0;
 
         size_t move_count = 0;
         for (size_t idx = 0; move_count < _size && idx < prev_cap; idx++)
@@ -121,7 +148,6 @@ public:
             if (prev_table[idx].state != state_t::ACTIVE)
                 continue;
 
-            key_t& key = prev_table[idx].pair.key;
             hash_t h = prev_table[idx].hash;
 
             size_t probe_start = h % _capacity;
@@ -142,57 +168,45 @@ public:
             }
         }
 
-        free(prev_table);
+        _allocator.deallocate(prev_table, prev_cap * sizeof(slot_t));
     }
 
+    // Nothing is left behind, so a cleared table probes as short as a new one
     void clear()
     {
-        for (size_t i = 0; _size > 0 && i < _capacity; i++)
+        for (size_t i = 0; i < _capacity; i++)
         {
             if (_table[i].state == state_t::ACTIVE)
             {
                 _table[i].pair.key.~key_t();
                 _table[i].pair.value.~value_t();
-
-                _table[i].state = state_t::TOMBSTONE;
-                _size--;
             }
+
+            _table[i].state = state_t::EMPTY;
         }
+
+        _size = _tombstones = 0;
+        _first = _capacity;
+        _last = 0;
     }
 
+    // Returns the existing value if the key is already present
     template<typename... Args>
-    value_t& emplace(const key_t& key, const Args&&... args)
+    value_t& emplace(const key_t& key, Args&&... args)
     {
-        if (load_factor() >= HASH_TABLE_MAX_LOAD_FACTOR)
-            resize(_capacity * HASH_TABLE_GROWTH_RATE);
-        
-        hash_t h = hash(key);
+        make_room();
 
-        size_t probe_start = h % _capacity;
-        size_t probe_end = (probe_start + _capacity - 1) % _capacity;
+        hash_t h = hash(key);
 
-        for (size_t i = probe_start; i != probe_end; i = (i + 1) % _capacity)
+        size_t slot = probe_for_insert(h);
+        if (_table[slot].state != state_t::ACTIVE)
         {
-            if (_table[i].state == state_t::ACTIVE)
-                break;
-
-            _first = std::min(_first, i);
-            _last = std::max(_last, i);
-
-            // Fill slot if it's empty or a tombstone
-
-            new(&_table[i].pair.key)   key_t(key);
-            new(&_table[i].pair.value) value_t(std::forward<Args>(args)...);
-
-            _table[i].hash  = h;
-            _table[i].state = state_t::ACTIVE;
-            _size++;
-
-            return _table[i].pair.value;
+            new(&_table[slot].pair.key)   key_t(key);
+            new(&_table[slot].pair.value) value_t(std::forward<Args>(args)...);
+            occupy(slot, h);
         }
 
-        ASSERT_NOT_VALID("hash_table::emplace() ran out of slots");
-        return _table[_capacity].pair.value;
+        return _table[slot].pair.value;
     }
 
     void erase(const key_t& key)
@@ -215,7 +229,15 @@ public:
             _table[i].pair.value.~value_t();
 
             size_t next_idx = (i + 1) % _capacity;
-            _table[i].state = (_table[next_idx].state == state_t::EMPTY) ? state_t::EMPTY : state_t::TOMBSTONE;
+            if (_table[next_idx].state == state_t::EMPTY)
+            {
+                _table[i].state = state_t::EMPTY;
+            }
+            else
+            {
+                _table[i].state = state_t::TOMBSTONE;
+                _tombstones++;
+            }
             _size--;
 
             break;
@@ -224,44 +246,19 @@ public:
 
     value_t& at(const key_t& key)
     {
-        if (load_factor() >= HASH_TABLE_MAX_LOAD_FACTOR)
-            resize(_capacity * HASH_TABLE_GROWTH_RATE);
-        
-        hash_t h = hash(key);
+        make_room();
 
-        size_t probe_start = h % _capacity;
-        size_t probe_end = (probe_start + _capacity - 1) % _capacity;
+        hash_t h = hash(key);
 
-        for (size_t i = probe_start; i != probe_end; i = (i + 1) % _capacity)
+        size_t slot = probe_for_insert(h);
+        if (_table[slot].state != state_t::ACTIVE)
         {
-            if (_table[i].state == state_t::TOMBSTONE)
-                continue;
-
-            if (_table[i].state == state_t::ACTIVE)
-            {
-                if (_table[i].hash != h)
-                    continue;
-                
-                return _table[i].pair.value;
-            }
-
-            // Encountered an empty element
-
-            _first = std::min(_first, i);
-            _last = std::max(_last, i);
-
-            new(&_table[i].pair.key)   key_t(key);
-            new(&_table[i].pair.value) value_t();
-
-            _table[i].hash  = h;
-            _table[i].state = state_t::ACTIVE;
-            _size++;
-
-            return _table[i].pair.value;
+            new(&_table[slot].pair.key)   key_t(key);
+            new(&_table[slot].pair.value) value_t();
+            occupy(slot, h);
         }
 
-        ASSERT_NOT_VALID("hash_table::at() ran out of slots");
-        return _table[_capacity].pair.value;
+        return _table[slot].pair.value;
     }
 
     iterator find(const key_t& key) const
@@ -276,13 +273,14 @@ public:
             if (_table[i].state == state_t::TOMBSTONE)
                 continue;
 
-            if (_table[i].state == state_t::ACTIVE)
-            {
-                if (_table[i].hash != h)
-                    continue;
-                
-                return iterator(this, i);
-            }
+            // Keys are never placed past an empty slot
+            if (_table[i].state == state_t::EMPTY)
+                break;
+
+            if (_table[i].hash != h)
+                continue;
+
+            return iterator(this, i);
         }
 
         return end();
@@ -300,13 +298,13 @@ public:
             if (_table[i].state == state_t::TOMBSTONE)
                 continue;
 
-            if (_table[i].state == state_t::ACTIVE)
-            {
-                if (_table[i].hash != h)
-                    continue;
-                
-                return _table[i].pair.value;
-            }
+            if (_table[i].state == state_t::EMPTY)
+                break;
+
+            if (_table[i].hash != h)
+                continue;
+
+            return _table[i].pair.value;
         }
 
         return _table[_last + 1].pair.value;
@@ -322,18 +320,45 @@ public:
         return at(key);
     }
 
-    void init(size_t start_capacity = 8)
+    table_stats stats() const
+    {
+        table_stats result;
+        result.size = _size;
+        result.capacity = _capacity;
+        result.load_factor = load_factor();
+
+        size_t total_probe = 0;
+        for (size_t i = 0; i < _capacity; i++)
+        {
+            if (_table[i].state != state_t::ACTIVE)
+                continue;
+
+            size_t home = _table[i].hash % _capacity;
+            size_t probe = (i + _capacity - home) % _capacity;
+
+            total_probe += probe;
+            result.max_probe = std::max(result.max_probe, probe);
+        }
+
+        if (_size > 0)
+            result.average_probe = (f64) total_probe / (f64) _size;
+
+        return result;
+    }
+
+    void init(size_t start_capacity = 8, const allocator_t& allocator = allocator_t())
     {
-        _last = _size = 0;
+        _allocator = allocator;
+        _last = _size = _tombstones = 0;
         _first = _capacity = start_capacity;
         _table = allocate_slots(_capacity);
     }
 
     // Constructors and Destructors
 
-    hash_table(size_t start_capacity = 8)
-    :   _size(0), _capacity(start_capacity),
-        _first(start_capacity), _last(0)
+    hash_table(size_t start_capacity = 8, const allocator_t& allocator = allocator_t())
+    :   _size(0), _capacity(start_capacity), _tombstones(0),
+        _allocator(allocator), _first(start_capacity), _last(0)
     {
         _table = allocate_slots(_capacity);
     }
@@ -341,16 +366,68 @@ public:
     ~hash_table()
     {
         clear();
-        free(_table);
+        _allocator.deallocate(_table, _capacity * sizeof(slot_t));
     }
 
 private:
 
     double load_factor() const { return (double) _size / (double) _capacity; }
 
-    static slot_t* allocate_slots(size_t count)
+    // Tombstones lengthen probes as much as live keys do, so they count towards the limit.
+    // When most of the used slots are tombstones the table is rehashed at the same size instead of grown.
+    void make_room()
+    {
+        if ((double) (_size + _tombstones) / (double) _capacity < HASH_TABLE_MAX_LOAD_FACTOR)
+            return;
+
+        bool mostly_live = load_factor() >= HASH_TABLE_MAX_LOAD_FACTOR / 2.0;
+        resize(mostly_live ? (size_t) (_capacity * HASH_TABLE_GROWTH_RATE) : _capacity);
+    }
+
+    // Returns the slot holding the key, or the first free slot along its probe when it's absent.
+    // Tombstones are only reused once the rest of the probe shows the key isn't further along.
+    size_t probe_for_insert(hash_t h) const
+    {
+        size_t probe_start = h % _capacity;
+        size_t probe_end = (probe_start + _capacity - 1) % _capacity;
+        size_t first_tombstone = _capacity;
+
+        for (size_t i = probe_start; i != probe_end; i = (i + 1) % _capacity)
+        {
+            if (_table[i].state == state_t::TOMBSTONE)
+            {
+                first_tombstone = std::min(first_tombstone, i);
+                continue;
+            }
+
+            if (_table[i].state == state_t::EMPTY)
+                return (first_tombstone != _capacity) ? first_tombstone : i;
+
+            if (_table[i].hash == h)
+                return i;
+        }
+
+        // make_room() keeps free slots around, so a probe can't come back empty handed
+        ASSERT(first_tombstone != _capacity);
+        return first_tombstone;
+    }
+
+    void occupy(size_t slot, hash_t h)
+    {
+        if (_table[slot].state == state_t::TOMBSTONE)
+            _tombstones--;
+
+        _first = std::min(_first, slot);
+        _last = std::max(_last, slot);
+
+        _table[slot].hash  = h;
+        _table[slot].state = state_t::ACTIVE;
+        _size++;
+    }
+
+    slot_t* allocate_slots(size_t count)
     {
-        slot_t* slots = (slot_t*) malloc(count * sizeof(slot_t));
+        slot_t* slots = (slot_t*) _allocator.allocate(count * sizeof(slot_t));
         for (size_t i = 0; i < count; i++)
             slots[i].state = state_t::EMPTY;
         return slots;
@@ -358,8 +435,9 @@ private:
 
 private:
     slot_t* _table;
-    size_t _size, _capacity;
+    size_t _size, _capacity, _tombstones;
     hasher hash;
+    allocator_t _allocator;
 
     size_t _first, _last;
 };
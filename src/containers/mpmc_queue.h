@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include "misc/gn_assert.h"
+
+#define MPMC_QUEUE_CACHE_LINE 64
+
+namespace gn {
+
+// Bounded lock-free queue for any number of producers and consumers (Dmitry Vyukov's design).
+// Every cell carries a sequence number that tells whether it is ready to be written
+// or read for the current lap, so producers and consumers only contend on their own index.
+// Capacity is rounded up to a power of 2.
+template <typename T>
+class mpmc_queue
+{
+public:
+    size_t capacity() const { return _mask + 1; }
+
+    bool try_push(const T& value)
+    {
+        return try_emplace(value);
+    }
+
+    bool try_push(T&& value)
+    {
+        return try_emplace(std::move(value));
+    }
+
+    template <typename... Args>
+    bool try_emplace(Args&&... args)
+    {
+        cell_t* cell;
+        size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            cell = &_cells[pos & _mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+
+            if (diff == 0)
+            {
+                if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // Cell still holds a value from the previous lap
+                return false;
+            }
+            else
+            {
+                pos = _enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        new(cell->value()) T(std::forward<Args>(args)...);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    bool try_pop(T& out)
+    {
+        cell_t* cell;
+        size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+
+        while (true)
+        {
+            cell = &_cells[pos & _mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = (intptr_t) seq - (intptr_t) (pos + 1);
+
+            if (diff == 0)
+            {
+                if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                // Nothing has been written to this cell yet
+                return false;
+            }
+            else
+            {
+                pos = _dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+
+        T* value = cell->value();
+        out = std::move(*value);
+        value->~T();
+
+        cell->sequence.store(pos + _mask + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Constructors and Destructors
+
+    mpmc_queue(size_t capacity)
+    {
+        size_t rounded = 2;
+        while (rounded < capacity)
+            rounded <<= 1;
+
+        _mask = rounded - 1;
+        _cells = (cell_t*) malloc(rounded * sizeof(cell_t));
+        ASSERT(_cells);
+
+        for (size_t i = 0; i < rounded; i++)
+            new(&_cells[i].sequence) std::atomic<size_t>(i);
+    }
+
+    mpmc_queue(const mpmc_queue&) = delete;
+    mpmc_queue& operator=(const mpmc_queue&) = delete;
+
+    ~mpmc_queue()
+    {
+        size_t head = _dequeue_pos.load(std::memory_order_relaxed);
+        size_t tail = _enqueue_pos.load(std::memory_order_relaxed);
+
+        for (; head != tail; head++)
+            _cells[head & _mask].value()->~T();
+
+        free(_cells);
+    }
+
+private:
+    struct cell_t
+    {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() { return (T*) storage; }
+    };
+
+    // Read only after construction
+    alignas(MPMC_QUEUE_CACHE_LINE) cell_t* _cells;
+    size_t _mask;
+
+    alignas(MPMC_QUEUE_CACHE_LINE) std::atomic<size_t> _enqueue_pos { 0 };
+    alignas(MPMC_QUEUE_CACHE_LINE) std::atomic<size_t> _dequeue_pos { 0 };
+    char _padding[MPMC_QUEUE_CACHE_LINE - sizeof(std::atomic<size_t>)];
+};
+
+} // namespace gn
\ No newline at end of file
@@ -0,0 +1,328 @@
+#pragma once
+
+#include <new>
+#include <utility>
+#include "allocator.h"
+#include "darray.h"
+#include "hash_table.h"
+#include "math/basic_types.h"
+#include "misc/gn_assert.h"
+
+#define ORDERED_TABLE_MAX_LOAD_FACTOR 0.66
+
+namespace gn {
+
+// Hash map that remembers insertion order, laid out like CPython's dict.
+// Pairs live in a dense entries array in the order they were added, and a
+// separate open addressed table of u32 indices points into it. Iteration walks
+// the entries array directly, lookups probe the small index table.
+// Erased entries are only marked dead and get compacted away on the next rebuild.
+template <typename key_t, typename value_t, typename hasher = hash<key_t>, typename allocator_t = heap_allocator>
+class ordered_table
+{
+public:
+    struct pair_t
+    {
+        key_t   key;
+        value_t value;
+    };
+
+    struct entry_t
+    {
+        hash_t hash;
+        bool   alive;
+        pair_t pair;
+    };
+
+    struct iterator
+    {
+        const ordered_table* table;
+        size_t index;
+
+        iterator(const ordered_table* table, size_t index)
+        :   table(table), index(index)
+        {
+            skip_dead();
+        }
+
+        void skip_dead()
+        {
+            while (index < table->_entries.size() && !table->_entries[index].alive)
+                index++;
+        }
+
+        iterator& operator++()
+        {
+            index++;
+            skip_dead();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator it = *this;
+            index++;
+            skip_dead();
+            return it;
+        }
+
+        const pair_t& operator*() const
+        {
+            return table->_entries[index].pair;
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return table == other.table &&
+                   index == other.index;
+        }
+
+        bool operator!=(const iterator& other) const
+        {
+            return table != other.table ||
+                   index != other.index;
+        }
+    };
+
+    size_t size() const { return _size; }
+    size_t capacity() const { return _index_capacity; }
+
+    iterator begin() const { return iterator(this, 0); }
+    iterator end() const { return iterator(this, _entries.size()); }
+
+    // Returns the existing value if the key is already present, same as hash_table
+    template<typename... Args>
+    value_t& emplace(const key_t& key, Args&&... args)
+    {
+        hash_t h = hash(key);
+
+        size_t slot = find_slot(key, h);
+        if (_indices[slot] != EMPTY_INDEX)
+            return _entries[_indices[slot]].pair.value;
+
+        return insert_new(key, h, std::forward<Args>(args)...);
+    }
+
+    void erase(const key_t& key)
+    {
+        hash_t h = hash(key);
+
+        size_t slot = find_slot(key, h);
+        if (_indices[slot] == EMPTY_INDEX)
+            return;
+
+        _entries[_indices[slot]].alive = false;
+        _indices[slot] = DELETED_INDEX;
+        _size--;
+    }
+
+    iterator find(const key_t& key) const
+    {
+        size_t slot = find_slot(key, hash(key));
+
+        if (_indices[slot] == EMPTY_INDEX)
+            return end();
+
+        return iterator(this, _indices[slot]);
+    }
+
+    // Inserts a default value if the key isn't present
+    value_t& at(const key_t& key)
+    {
+        hash_t h = hash(key);
+
+        size_t slot = find_slot(key, h);
+        if (_indices[slot] != EMPTY_INDEX)
+            return _entries[_indices[slot]].pair.value;
+
+        return insert_new(key, h);
+    }
+
+    const value_t& at(const key_t& key) const
+    {
+        size_t slot = find_slot(key, hash(key));
+        ASSERT(_indices[slot] != EMPTY_INDEX);
+
+        return _entries[_indices[slot]].pair.value;
+    }
+
+    value_t& operator[](const key_t& key)
+    {
+        return at(key);
+    }
+
+    const value_t& operator[](const key_t& key) const
+    {
+        return at(key);
+    }
+
+    table_stats stats() const
+    {
+        table_stats result;
+        result.size = _size;
+        result.capacity = _index_capacity;
+        result.load_factor = (f64) _entries.size() / (f64) _index_capacity;
+
+        size_t mask = _index_capacity - 1;
+        size_t total_probe = 0;
+
+        for (size_t i = 0; i < _index_capacity; i++)
+        {
+            if (_indices[i] == EMPTY_INDEX || _indices[i] == DELETED_INDEX)
+                continue;
+
+            size_t probe = (i - _entries[_indices[i]].hash) & mask;
+
+            total_probe += probe;
+            if (probe > result.max_probe)
+                result.max_probe = probe;
+        }
+
+        if (_size > 0)
+            result.average_probe = (f64) total_probe / (f64) _size;
+
+        return result;
+    }
+
+    void clear()
+    {
+        _entries.clear();
+        _size = 0;
+
+        for (size_t i = 0; i < _index_capacity; i++)
+            _indices[i] = EMPTY_INDEX;
+    }
+
+    void init(size_t start_capacity = 8, const allocator_t& allocator = allocator_t())
+    {
+        _allocator = allocator;
+        _entries.init(start_capacity, allocator);
+        _size = 0;
+
+        _index_capacity = index_capacity_for(start_capacity);
+        _indices = allocate_indices(_index_capacity);
+    }
+
+    // Constructors and Destructors
+
+    ordered_table(size_t start_capacity = 8, const allocator_t& allocator = allocator_t())
+    :   _entries(start_capacity, allocator), _indices(nullptr),
+        _index_capacity(0), _size(0), _allocator(allocator)
+    {
+        _index_capacity = index_capacity_for(start_capacity);
+        _indices = allocate_indices(_index_capacity);
+    }
+
+    ordered_table(const ordered_table&) = delete;
+    ordered_table& operator=(const ordered_table&) = delete;
+
+    ~ordered_table()
+    {
+        _allocator.deallocate(_indices, _index_capacity * sizeof(u32));
+    }
+
+private:
+    static constexpr u32 EMPTY_INDEX   = 0xFFFFFFFF;
+    static constexpr u32 DELETED_INDEX = 0xFFFFFFFE;
+
+    static size_t index_capacity_for(size_t entry_count)
+    {
+        size_t cap = 8;
+        while (cap * ORDERED_TABLE_MAX_LOAD_FACTOR < entry_count)
+            cap <<= 1;
+
+        return cap;
+    }
+
+    u32* allocate_indices(size_t count)
+    {
+        u32* indices = (u32*) _allocator.allocate(count * sizeof(u32));
+        for (size_t i = 0; i < count; i++)
+            indices[i] = EMPTY_INDEX;
+
+        return indices;
+    }
+
+    // Returns the slot holding the key, or the empty slot where the probe stopped
+    size_t find_slot(const key_t& key, hash_t h) const
+    {
+        size_t mask = _index_capacity - 1;
+
+        for (size_t i = h & mask; ; i = (i + 1) & mask)
+        {
+            u32 index = _indices[i];
+
+            if (index == EMPTY_INDEX)
+                return i;
+
+            if (index == DELETED_INDEX)
+                continue;
+
+            const entry_t& entry = _entries[index];
+            if (entry.hash == h && entry.pair.key == key)
+                return i;
+        }
+    }
+
+    template<typename... Args>
+    value_t& insert_new(const key_t& key, hash_t h, Args&&... args)
+    {
+        // Dead entries still occupy index slots until the next rebuild
+        if (_entries.size() + 1 > _index_capacity * ORDERED_TABLE_MAX_LOAD_FACTOR)
+            rebuild(_size + 1);
+
+        size_t mask = _index_capacity - 1;
+        size_t slot = h & mask;
+        while (_indices[slot] != EMPTY_INDEX)
+            slot = (slot + 1) & mask;
+
+        _indices[slot] = (u32) _entries.size();
+
+        entry_t& entry = _entries.emplace_back(entry_t { h, true, pair_t { key, value_t(std::forward<Args>(args)...) } });
+        _size++;
+
+        return entry.pair.value;
+    }
+
+    // Drops dead entries and resizes the index table to fit the live ones
+    void rebuild(size_t min_entries)
+    {
+        if (_size != _entries.size())
+        {
+            darray<entry_t, allocator_t> live(_entries.capacity(), _allocator);
+
+            for (entry_t& entry : _entries)
+            {
+                if (entry.alive)
+                    live.emplace_back(std::move(entry));
+            }
+
+            _entries = std::move(live);
+        }
+
+        _allocator.deallocate(_indices, _index_capacity * sizeof(u32));
+
+        _index_capacity = index_capacity_for(min_entries * 2);
+        _indices = allocate_indices(_index_capacity);
+
+        size_t mask = _index_capacity - 1;
+        for (size_t i = 0; i < _entries.size(); i++)
+        {
+            size_t slot = _entries[i].hash & mask;
+            while (_indices[slot] != EMPTY_INDEX)
+                slot = (slot + 1) & mask;
+
+            _indices[slot] = (u32) i;
+        }
+    }
+
+private:
+    darray<entry_t, allocator_t> _entries;
+    u32* _indices;
+    size_t _index_capacity;
+    size_t _size;
+    hasher hash;
+    allocator_t _allocator;
+};
+
+} // namespace gn
\ No newline at end of file
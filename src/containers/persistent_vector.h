@@ -0,0 +1,343 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include "math/basic_types.h"
+#include "misc/gn_assert.h"
+
+#define PERSISTENT_VECTOR_BITS 5
+
+namespace gn {
+
+// Vector with structural sharing, stored as a radix tree of 32 wide nodes.
+// Copying is O(1) and only bumps a reference count, so copies can be kept as
+// snapshots (undo history, background saves). Writing to a shared vector copies
+// just the leaf and the few branches on the path to it, untouched chunks stay
+// shared between all snapshots. Reference counts are atomic so a snapshot can be
+// handed to another thread, but a single vector must not be written from two threads.
+template <typename T>
+class persistent_vector
+{
+public:
+    static constexpr u32 WIDTH = 1 << PERSISTENT_VECTOR_BITS;
+    static constexpr u32 MASK  = WIDTH - 1;
+
+    size_t size() const { return _size; }
+
+    const T& operator[](size_t index) const
+    {
+        ASSERT(index < _size);
+        return leaf_for(index)->values()[index & MASK];
+    }
+
+    // Returns a mutable reference, copying the path to the element if it is shared
+    T& edit(size_t index)
+    {
+        ASSERT(index < _size);
+        return edit_leaf(index)->values()[index & MASK];
+    }
+
+    void set(size_t index, const T& value)
+    {
+        edit(index) = value;
+    }
+
+    void set(size_t index, T&& value)
+    {
+        edit(index) = std::move(value);
+    }
+
+    T& push_back(const T& value)
+    {
+        return emplace_back(value);
+    }
+
+    T& push_back(T&& value)
+    {
+        return emplace_back(std::move(value));
+    }
+
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        if (_root == nullptr)
+        {
+            _root = allocate_leaf();
+            _shift = 0;
+        }
+        else if (_size == ((size_t) WIDTH << _shift))
+        {
+            // Tree is full, add a level on top
+            branch_t* root = allocate_branch();
+            root->children[0] = _root;
+
+            _root = root;
+            _shift += PERSISTENT_VECTOR_BITS;
+        }
+
+        leaf_t* leaf = edit_leaf(_size);
+        T* value = new(&leaf->values()[_size & MASK]) T(std::forward<Args>(args)...);
+        leaf->count++;
+        _size++;
+
+        return *value;
+    }
+
+    void pop_back()
+    {
+        if (_size == 0)
+            return;
+
+        if (_size == 1)
+        {
+            clear();
+            return;
+        }
+
+        _size--;
+
+        leaf_t* leaf = edit_leaf(_size);
+        leaf->values()[_size & MASK].~T();
+        leaf->count--;
+    }
+
+    void clear()
+    {
+        release(_root, _shift);
+        _root = nullptr;
+        _shift = 0;
+        _size = 0;
+    }
+
+    // True if both vectors share the same tree, useful to skip work on unchanged snapshots
+    bool shares_root_with(const persistent_vector& other) const
+    {
+        return _root == other._root;
+    }
+
+    // Constructors and Destructors
+
+    persistent_vector() = default;
+
+    persistent_vector(const persistent_vector& other)
+    :   _root(other._root), _shift(other._shift), _size(other._size)
+    {
+        retain(_root);
+    }
+
+    persistent_vector(persistent_vector&& other)
+    :   _root(other._root), _shift(other._shift), _size(other._size)
+    {
+        other._root = nullptr;
+        other._shift = 0;
+        other._size = 0;
+    }
+
+    ~persistent_vector()
+    {
+        release(_root, _shift);
+    }
+
+    persistent_vector& operator=(const persistent_vector& other)
+    {
+        retain(other._root);
+        release(_root, _shift);
+
+        _root = other._root;
+        _shift = other._shift;
+        _size = other._size;
+
+        return *this;
+    }
+
+    persistent_vector& operator=(persistent_vector&& other)
+    {
+        if (this == &other)
+            return *this;
+
+        release(_root, _shift);
+
+        _root = other._root;
+        _shift = other._shift;
+        _size = other._size;
+
+        other._root = nullptr;
+        other._shift = 0;
+        other._size = 0;
+
+        return *this;
+    }
+
+private:
+    struct node_t
+    {
+        std::atomic<u32> refs;
+        u32 count;      // Constructed values, only used by leaves
+    };
+
+    struct branch_t : node_t
+    {
+        node_t* children[WIDTH];
+    };
+
+    struct leaf_t : node_t
+    {
+        alignas(T) u8 storage[WIDTH * sizeof(T)];
+
+        T* values() { return (T*) storage; }
+        const T* values() const { return (const T*) storage; }
+    };
+
+    // malloc only guarantees alignment for the fundamental types, leaves can hold over aligned T
+    static void* allocate_node(size_t bytes, size_t alignment)
+    {
+        bytes = (bytes + alignment - 1) & ~(alignment - 1);
+
+#       ifdef _MSC_VER
+        return _aligned_malloc(bytes, alignment);
+#       else
+        return aligned_alloc(alignment, bytes);
+#       endif
+    }
+
+    static void free_node(void* node)
+    {
+#       ifdef _MSC_VER
+        _aligned_free(node);
+#       else
+        free(node);
+#       endif
+    }
+
+    static leaf_t* allocate_leaf()
+    {
+        leaf_t* leaf = (leaf_t*) allocate_node(sizeof(leaf_t), alignof(leaf_t));
+        ASSERT(leaf);
+
+        new(&leaf->refs) std::atomic<u32>(1);
+        leaf->count = 0;
+        return leaf;
+    }
+
+    static branch_t* allocate_branch()
+    {
+        branch_t* branch = (branch_t*) allocate_node(sizeof(branch_t), alignof(branch_t));
+        ASSERT(branch);
+
+        new(&branch->refs) std::atomic<u32>(1);
+        branch->count = 0;
+        for (u32 i = 0; i < WIDTH; i++)
+            branch->children[i] = nullptr;
+
+        return branch;
+    }
+
+    static void retain(node_t* node)
+    {
+        if (node)
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void release(node_t* node, u32 shift)
+    {
+        if (node == nullptr)
+            return;
+
+        if (node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+            return;
+
+        if (shift == 0)
+        {
+            leaf_t* leaf = (leaf_t*) node;
+            for (u32 i = 0; i < leaf->count; i++)
+                leaf->values()[i].~T();
+        }
+        else
+        {
+            branch_t* branch = (branch_t*) node;
+            for (u32 i = 0; i < WIDTH; i++)
+                release(branch->children[i], shift - PERSISTENT_VECTOR_BITS);
+        }
+
+        node->refs.~atomic();
+        free_node(node);
+    }
+
+    // Makes sure the node in the slot is owned only by this vector, copying it if needed.
+    // Missing nodes on the path of a push are created here as well.
+    static void make_unique(node_t*& slot, u32 shift)
+    {
+        if (slot == nullptr)
+        {
+            slot = (shift == 0) ? (node_t*) allocate_leaf() : (node_t*) allocate_branch();
+            return;
+        }
+
+        if (slot->refs.load(std::memory_order_acquire) == 1)
+            return;
+
+        node_t* copy;
+
+        if (shift == 0)
+        {
+            leaf_t* leaf = (leaf_t*) slot;
+            leaf_t* leaf_copy = allocate_leaf();
+
+            for (u32 i = 0; i < leaf->count; i++)
+                new(&leaf_copy->values()[i]) T(leaf->values()[i]);
+
+            leaf_copy->count = leaf->count;
+            copy = leaf_copy;
+        }
+        else
+        {
+            branch_t* branch = (branch_t*) slot;
+            branch_t* branch_copy = allocate_branch();
+
+            for (u32 i = 0; i < WIDTH; i++)
+            {
+                branch_copy->children[i] = branch->children[i];
+                retain(branch->children[i]);
+            }
+
+            copy = branch_copy;
+        }
+
+        release(slot, shift);
+        slot = copy;
+    }
+
+    const leaf_t* leaf_for(size_t index) const
+    {
+        const node_t* node = _root;
+
+        for (u32 shift = _shift; shift > 0; shift -= PERSISTENT_VECTOR_BITS)
+            node = ((const branch_t*) node)->children[(index >> shift) & MASK];
+
+        return (const leaf_t*) node;
+    }
+
+    leaf_t* edit_leaf(size_t index)
+    {
+        make_unique(_root, _shift);
+        node_t* node = _root;
+
+        for (u32 shift = _shift; shift > 0; shift -= PERSISTENT_VECTOR_BITS)
+        {
+            node_t*& child = ((branch_t*) node)->children[(index >> shift) & MASK];
+            make_unique(child, shift - PERSISTENT_VECTOR_BITS);
+            node = child;
+        }
+
+        return (leaf_t*) node;
+    }
+
+private:
+    node_t* _root = nullptr;
+    u32 _shift = 0;
+    size_t _size = 0;
+};
+
+} // namespace gn
\ No newline at end of file
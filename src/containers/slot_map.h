@@ -0,0 +1,302 @@
+#pragma once
+
+#include <new>
+#include <tuple>
+#include <utility>
+#include "darray.h"
+#include "soa_darray.h"
+#include "math/basic_types.h"
+#include "misc/gn_assert.h"
+
+#define SLOT_MAP_START_CAPACITY 8
+
+namespace gn {
+
+// A default constructed handle never refers to a live element
+// since generations of used slots start from 1.
+struct slot_handle
+{
+    u32 index      = 0;
+    u32 generation = 0;
+
+    bool operator==(const slot_handle& other) const
+    {
+        return index == other.index &&
+               generation == other.generation;
+    }
+
+    bool operator!=(const slot_handle& other) const
+    {
+        return index != other.index ||
+               generation != other.generation;
+    }
+};
+
+// Elements are stored densely and are addressed through generation checked handles.
+// Insert, erase and lookup are O(1); handles to erased elements simply stop resolving.
+// erase() moves the last element into the hole, erase_ordered() keeps the dense order.
+// The dense storage is a darray by default, soa_slot_map below keeps it as a soa_darray.
+template <typename T, typename storage_t = darray<T>>
+class slot_map
+{
+public:
+    using iterator = T*;
+
+    // T& for darray storage, a tuple of references to the fields for soa_darray
+    using reference       = decltype(std::declval<storage_t&>()[0]);
+    using const_reference = decltype(std::declval<const storage_t&>()[0]);
+
+    size_t size() const { return _dense.size(); }
+
+    const T* data() const { return _dense.data(); }
+          T* data()       { return _dense.data(); }
+
+    // Elements in dense order, for batch code that walks all of them
+    const storage_t& dense() const { return _dense; }
+          storage_t& dense()       { return _dense; }
+
+    template <typename... Args>
+    slot_handle emplace(Args&&... args)
+    {
+        u32 slot_index;
+
+        if (_free_head != INVALID_INDEX)
+        {
+            slot_index = _free_head;
+            _free_head = _slots[slot_index].dense_index;
+        }
+        else
+        {
+            slot_index = (u32) _slots.size();
+            _slots.emplace_back();
+            _slots[slot_index].generation = 1;
+        }
+
+        slot_t& slot = _slots[slot_index];
+        slot.dense_index = (u32) _dense.size();
+
+        _dense.emplace_back(std::forward<Args>(args)...);
+        _dense_to_slot.emplace_back(slot_index);
+
+        return slot_handle { slot_index, slot.generation };
+    }
+
+    slot_handle insert(const T& value)
+    {
+        return emplace(value);
+    }
+
+    bool contains(slot_handle handle) const
+    {
+        return handle.index < _slots.size() &&
+               _slots[handle.index].generation == handle.generation;
+    }
+
+    // Returns nullptr if the element was erased
+    T* find(slot_handle handle)
+    {
+        if (!contains(handle))
+            return nullptr;
+
+        return &_dense[_slots[handle.index].dense_index];
+    }
+
+    const T* find(slot_handle handle) const
+    {
+        if (!contains(handle))
+            return nullptr;
+
+        return &_dense[_slots[handle.index].dense_index];
+    }
+
+    // Position of the element in dense order, -1 if the element was erased
+    s64 index_of(slot_handle handle) const
+    {
+        if (!contains(handle))
+            return -1;
+
+        return _slots[handle.index].dense_index;
+    }
+
+    slot_handle handle_at(size_t index) const
+    {
+        ASSERT(index < _dense.size());
+
+        u32 slot_index = _dense_to_slot[index];
+        return slot_handle { slot_index, _slots[slot_index].generation };
+    }
+
+    // O(1), the last element takes the place of the erased one
+    void erase(slot_handle handle)
+    {
+        if (!contains(handle))
+            return;
+
+        u32 dense_index = _slots[handle.index].dense_index;
+        u32 last_index  = (u32) _dense.size() - 1;
+
+        if (dense_index != last_index)
+        {
+            _dense[dense_index] = std::move(_dense[last_index]);
+            _dense_to_slot[dense_index] = _dense_to_slot[last_index];
+            _slots[_dense_to_slot[dense_index]].dense_index = dense_index;
+        }
+
+        _dense.pop_back();
+        _dense_to_slot.pop_back();
+
+        release_slot(handle.index);
+    }
+
+    // O(n), elements after the erased one are shifted down to keep their order
+    void erase_ordered(slot_handle handle)
+    {
+        if (!contains(handle))
+            return;
+
+        u32 dense_index = _slots[handle.index].dense_index;
+
+        for (u32 i = dense_index; i + 1 < _dense.size(); i++)
+        {
+            _dense[i] = std::move(_dense[i + 1]);
+            _dense_to_slot[i] = _dense_to_slot[i + 1];
+            _slots[_dense_to_slot[i]].dense_index = i;
+        }
+
+        _dense.pop_back();
+        _dense_to_slot.pop_back();
+
+        release_slot(handle.index);
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < _dense_to_slot.size(); i++)
+            release_slot(_dense_to_slot[i]);
+
+        _dense.clear();
+        _dense_to_slot.clear();
+    }
+
+    const_reference back() const { return _dense[_dense.size() - 1]; }
+          reference back()       { return _dense[_dense.size() - 1]; }
+
+    // Iterators and C++11 stuff
+
+    iterator begin() const { return _dense.begin(); }
+    iterator end()   const { return _dense.end(); }
+
+    // Constructors and Destructors
+
+    slot_map(size_t capacity = SLOT_MAP_START_CAPACITY)
+    :   _dense(capacity), _dense_to_slot(capacity),
+        _slots(capacity), _free_head(INVALID_INDEX) {}
+
+    slot_map(const slot_map& other)
+    :   _dense(other._dense.capacity()), _dense_to_slot(other._dense_to_slot),
+        _slots(other._slots), _free_head(other._free_head)
+    {
+        copy_dense(_dense, other._dense);
+    }
+
+    slot_map(slot_map&& other)
+    :   _dense(std::move(other._dense)), _dense_to_slot(std::move(other._dense_to_slot)),
+        _slots(std::move(other._slots)), _free_head(other._free_head)
+    {
+        other._free_head = INVALID_INDEX;
+    }
+
+    ~slot_map() = default;
+
+    // Dense access, same as iterating
+    const_reference operator[](size_t index) const { return _dense[index]; }
+          reference operator[](size_t index)       { return _dense[index]; }
+
+    const_reference operator[](slot_handle handle) const
+    {
+        ASSERT(contains(handle));
+        return _dense[_slots[handle.index].dense_index];
+    }
+
+    reference operator[](slot_handle handle)
+    {
+        ASSERT(contains(handle));
+        return _dense[_slots[handle.index].dense_index];
+    }
+
+    slot_map& operator=(const slot_map& other)
+    {
+        if (this == &other)
+            return *this;
+
+        _dense.clear();
+        copy_dense(_dense, other._dense);
+
+        _dense_to_slot = other._dense_to_slot;
+        _slots = other._slots;
+        _free_head = other._free_head;
+
+        return *this;
+    }
+
+    slot_map& operator=(slot_map&& other)
+    {
+        _dense = std::move(other._dense);
+        _dense_to_slot = std::move(other._dense_to_slot);
+        _slots = std::move(other._slots);
+        _free_head = other._free_head;
+
+        other._free_head = INVALID_INDEX;
+
+        return *this;
+    }
+
+private:
+    static constexpr u32 INVALID_INDEX = 0xFFFFFFFF;
+
+    struct slot_t
+    {
+        u32 dense_index;    // Next free slot if the slot is unused
+        u32 generation;
+    };
+
+    // darray's copy assigns into unconstructed memory, so elements are copy constructed one by one
+    template <typename U>
+    static void copy_dense(darray<U>& to, const darray<U>& from)
+    {
+        for (const U& value : from)
+            to.emplace_back(value);
+    }
+
+    template <typename... Fields>
+    static void copy_dense(soa_darray<Fields...>& to, const soa_darray<Fields...>& from)
+    {
+        to = from;
+    }
+
+    void release_slot(u32 slot_index)
+    {
+        slot_t& slot = _slots[slot_index];
+
+        // Skip 0 so default constructed handles stay invalid
+        slot.generation++;
+        if (slot.generation == 0)
+            slot.generation = 1;
+
+        slot.dense_index = _free_head;
+        _free_head = slot_index;
+    }
+
+private:
+    storage_t      _dense;
+    darray<u32>    _dense_to_slot;
+    darray<slot_t> _slots;
+    u32            _free_head;
+};
+
+// Rows are added with emplace(fields...) and read as tuples of references:
+//     auto [rect, pivot] = frames[handle];
+template <typename... Fields>
+using soa_slot_map = slot_map<std::tuple<Fields...>, soa_darray<Fields...>>;
+
+} // namespace gn
\ No newline at end of file
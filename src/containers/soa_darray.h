@@ -0,0 +1,379 @@
+#pragma once
+
+#include <cstdlib>
+#include <new>
+#include <tuple>
+#include <utility>
+#include "misc/gn_assert.h"
+
+#define SOA_DARRAY_START_CAPACITY   2
+#define SOA_DARRAY_GROWTH_RATE      1.5
+#define SOA_DARRAY_ALIGNMENT        32      // Wide enough for AVX loads
+
+namespace gn {
+
+// Dynamic array that keeps every field in its own aligned buffer.
+// Rows are accessed as tuples of references so structured bindings work:
+//     auto [topLeft, size, pivot] = frames[i];
+// and batch code can stream over a single field with field<I>().
+template <typename... Fields>
+class soa_darray
+{
+    static_assert(sizeof...(Fields) > 0, "soa_darray needs at least one field");
+
+public:
+    static constexpr size_t field_count = sizeof...(Fields);
+
+    template <size_t I>
+    using field_t = std::tuple_element_t<I, std::tuple<Fields...>>;
+
+    using row_t       = std::tuple<Fields&...>;
+    using const_row_t = std::tuple<const Fields&...>;
+
+    struct iterator
+    {
+        soa_darray* array;
+        size_t index;
+
+        iterator(soa_darray* array, size_t index)
+        :   array(array), index(index) {}
+
+        iterator& operator++()
+        {
+            index++;
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            iterator it = *this;
+            index++;
+            return it;
+        }
+
+        row_t operator*() const
+        {
+            return (*array)[index];
+        }
+
+        bool operator==(const iterator& other) const
+        {
+            return array == other.array &&
+                   index == other.index;
+        }
+
+        bool operator!=(const iterator& other) const
+        {
+            return array != other.array ||
+                   index != other.index;
+        }
+    };
+
+    size_t size()     const { return _size; }
+    size_t capacity() const { return _capacity; }
+
+    template <size_t I>
+    const field_t<I>* field() const { return (const field_t<I>*) _fields[I]; }
+
+    template <size_t I>
+          field_t<I>* field()       { return (field_t<I>*) _fields[I]; }
+
+    void init(size_t capacity = SOA_DARRAY_START_CAPACITY)
+    {
+        _size = 0;
+        _capacity = 0;
+        for (size_t i = 0; i < field_count; i++)
+            _fields[i] = nullptr;
+
+        reallocate(capacity);
+    }
+
+    // Only capacity is increased
+    void reserve(size_t capacity)
+    {
+        if (capacity > _capacity)
+            reallocate(capacity);
+    }
+
+    // New rows are default constructed
+    void resize(size_t size)
+    {
+        while (_size > size)
+            pop_back();
+
+        reserve(size);
+
+        while (_size < size)
+            emplace_back();
+    }
+
+    row_t push_back(const Fields&... values)
+    {
+        if (_size >= _capacity)
+            grow();
+
+        construct_row(_size, std::index_sequence_for<Fields...>(), values...);
+        return (*this)[_size++];
+    }
+
+    row_t emplace_back()
+    {
+        if (_size >= _capacity)
+            grow();
+
+        construct_default_row(_size, std::index_sequence_for<Fields...>());
+        return (*this)[_size++];
+    }
+
+    // Same as push_back, so the container can stand in for darray as slot_map storage
+    row_t emplace_back(const Fields&... values)
+    {
+        return push_back(values...);
+    }
+
+    void pop_back()
+    {
+        if (_size > 0)
+        {
+            _size--;
+            destroy_row(_size, std::index_sequence_for<Fields...>());
+        }
+    }
+
+    // Keeps the order of the remaining rows
+    void erase_at(size_t index)
+    {
+        ASSERT(index < _size);
+
+        for (size_t i = index; i + 1 < _size; i++)
+            move_row(i, i + 1, std::index_sequence_for<Fields...>());
+
+        pop_back();
+    }
+
+    void erase_swap(size_t index)
+    {
+        ASSERT(index < _size);
+
+        if (index + 1 < _size)
+            move_row(index, _size - 1, std::index_sequence_for<Fields...>());
+
+        pop_back();
+    }
+
+    void clear()
+    {
+        while (_size > 0)
+            pop_back();
+    }
+
+    // Iterators and C++11 stuff
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end()   { return iterator(this, _size); }
+
+    // Constructors and Destructors
+
+    soa_darray(size_t capacity = SOA_DARRAY_START_CAPACITY)
+    {
+        init(capacity);
+    }
+
+    soa_darray(const soa_darray& other)
+    {
+        init(other._capacity);
+
+        for (; _size < other._size; _size++)
+            copy_row(_size, other, std::index_sequence_for<Fields...>());
+    }
+
+    soa_darray(soa_darray&& other)
+    :   _size(other._size), _capacity(other._capacity)
+    {
+        for (size_t i = 0; i < field_count; i++)
+        {
+            _fields[i] = other._fields[i];
+            other._fields[i] = nullptr;
+        }
+
+        other._size = other._capacity = 0;
+    }
+
+    ~soa_darray()
+    {
+        clear();
+        free_fields();
+    }
+
+    row_t operator[](size_t index)
+    {
+        ASSERT(index < _size);
+        return get_row(index, std::index_sequence_for<Fields...>());
+    }
+
+    const_row_t operator[](size_t index) const
+    {
+        ASSERT(index < _size);
+        return get_row(index, std::index_sequence_for<Fields...>());
+    }
+
+    soa_darray& operator=(const soa_darray& other)
+    {
+        if (this == &other)
+            return *this;
+
+        clear();
+        reserve(other._capacity);
+
+        for (; _size < other._size; _size++)
+            copy_row(_size, other, std::index_sequence_for<Fields...>());
+
+        return *this;
+    }
+
+    soa_darray& operator=(soa_darray&& other)
+    {
+        if (this == &other)
+            return *this;
+
+        clear();
+        free_fields();
+
+        _size = other._size;
+        _capacity = other._capacity;
+
+        for (size_t i = 0; i < field_count; i++)
+        {
+            _fields[i] = other._fields[i];
+            other._fields[i] = nullptr;
+        }
+
+        other._size = other._capacity = 0;
+
+        return *this;
+    }
+
+private:
+    static void* allocate_field(size_t bytes)
+    {
+        // Round up so every field buffer can be read in whole SIMD registers
+        bytes = (bytes + SOA_DARRAY_ALIGNMENT - 1) & ~(size_t) (SOA_DARRAY_ALIGNMENT - 1);
+
+#       ifdef _MSC_VER
+        return _aligned_malloc(bytes, SOA_DARRAY_ALIGNMENT);
+#       else
+        return aligned_alloc(SOA_DARRAY_ALIGNMENT, bytes);
+#       endif
+    }
+
+    static void free_field(void* buffer)
+    {
+#       ifdef _MSC_VER
+        _aligned_free(buffer);
+#       else
+        free(buffer);
+#       endif
+    }
+
+    void free_fields()
+    {
+        for (size_t i = 0; i < field_count; i++)
+        {
+            free_field(_fields[i]);
+            _fields[i] = nullptr;
+        }
+    }
+
+    void grow()
+    {
+        size_t new_cap = _capacity * SOA_DARRAY_GROWTH_RATE;
+        reallocate(new_cap > _capacity ? new_cap : _capacity + 1);
+    }
+
+    template <size_t I>
+    void reallocate_field(size_t new_cap)
+    {
+        using T = field_t<I>;
+
+        T* old_buffer = (T*) _fields[I];
+        T* new_buffer = (T*) allocate_field(new_cap * sizeof(T));
+        ASSERT(new_buffer);
+
+        for (size_t i = 0; i < _size; i++)
+        {
+            new(&new_buffer[i]) T(std::move(old_buffer[i]));
+            old_buffer[i].~T();
+        }
+
+        free_field(old_buffer);
+        _fields[I] = new_buffer;
+    }
+
+    template <size_t... I>
+    void reallocate_fields(size_t new_cap, std::index_sequence<I...>)
+    {
+        (reallocate_field<I>(new_cap), ...);
+    }
+
+    void reallocate(size_t new_cap)
+    {
+        ASSERT(_size <= new_cap);
+
+        reallocate_fields(new_cap, std::index_sequence_for<Fields...>());
+        _capacity = new_cap;
+    }
+
+    template <size_t... I>
+    row_t get_row(size_t index, std::index_sequence<I...>)
+    {
+        return row_t(field<I>()[index]...);
+    }
+
+    template <size_t... I>
+    const_row_t get_row(size_t index, std::index_sequence<I...>) const
+    {
+        return const_row_t(field<I>()[index]...);
+    }
+
+    template <size_t... I>
+    void construct_row(size_t index, std::index_sequence<I...>, const Fields&... values)
+    {
+        (new(&field<I>()[index]) field_t<I>(values), ...);
+    }
+
+    template <size_t... I>
+    void construct_default_row(size_t index, std::index_sequence<I...>)
+    {
+        (new(&field<I>()[index]) field_t<I>(), ...);
+    }
+
+    template <size_t... I>
+    void copy_row(size_t index, const soa_darray& other, std::index_sequence<I...>)
+    {
+        (new(&field<I>()[index]) field_t<I>(other.field<I>()[index]), ...);
+    }
+
+    template <size_t... I>
+    void move_row(size_t dst, size_t src, std::index_sequence<I...>)
+    {
+        ((field<I>()[dst] = std::move(field<I>()[src])), ...);
+    }
+
+    template <size_t... I>
+    void destroy_row(size_t index, std::index_sequence<I...>)
+    {
+        (destroy(field<I>()[index]), ...);
+    }
+
+    template <typename T>
+    static void destroy(T& value)
+    {
+        value.~T();
+    }
+
+private:
+    size_t _size = 0, _capacity = 0;
+    void* _fields[field_count];
+};
+
+} // namespace gn
\ No newline at end of file
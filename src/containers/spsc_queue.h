@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include "misc/gn_assert.h"
+
+#define SPSC_QUEUE_CACHE_LINE 64
+
+namespace gn {
+
+// Bounded lock-free ring buffer for exactly one producer thread and one consumer thread.
+// Capacity is rounded up to a power of 2. Each side keeps a cached copy of the other
+// side's index so the shared cache line is only touched when the queue looks full/empty.
+template <typename T>
+class spsc_queue
+{
+public:
+    size_t capacity() const { return _mask + 1; }
+
+    // Approximate when called while the other thread is active
+    size_t size() const
+    {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+    }
+
+    // Producer only
+    bool try_push(const T& value)
+    {
+        return try_emplace(value);
+    }
+
+    // Producer only
+    bool try_push(T&& value)
+    {
+        return try_emplace(std::move(value));
+    }
+
+    // Producer only
+    template <typename... Args>
+    bool try_emplace(Args&&... args)
+    {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+
+        if (tail - _cached_head == capacity())
+        {
+            _cached_head = _head.load(std::memory_order_acquire);
+            if (tail - _cached_head == capacity())
+                return false;
+        }
+
+        new(&_buffer[tail & _mask]) T(std::forward<Args>(args)...);
+        _tail.store(tail + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Consumer only
+    bool try_pop(T& out)
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+
+        if (head == _cached_tail)
+        {
+            _cached_tail = _tail.load(std::memory_order_acquire);
+            if (head == _cached_tail)
+                return false;
+        }
+
+        T& slot = _buffer[head & _mask];
+        out = std::move(slot);
+        slot.~T();
+
+        _head.store(head + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Constructors and Destructors
+
+    spsc_queue(size_t capacity)
+    {
+        size_t rounded = 1;
+        while (rounded < capacity)
+            rounded <<= 1;
+
+        _mask = rounded - 1;
+        _buffer = (T*) malloc(rounded * sizeof(T));
+        ASSERT(_buffer);
+    }
+
+    spsc_queue(const spsc_queue&) = delete;
+    spsc_queue& operator=(const spsc_queue&) = delete;
+
+    ~spsc_queue()
+    {
+        size_t head = _head.load(std::memory_order_relaxed);
+        size_t tail = _tail.load(std::memory_order_relaxed);
+
+        for (; head != tail; head++)
+            _buffer[head & _mask].~T();
+
+        free(_buffer);
+    }
+
+private:
+    // Written by the consumer
+    alignas(SPSC_QUEUE_CACHE_LINE) std::atomic<size_t> _head { 0 };
+    size_t _cached_tail = 0;
+
+    // Written by the producer
+    alignas(SPSC_QUEUE_CACHE_LINE) std::atomic<size_t> _tail { 0 };
+    size_t _cached_head = 0;
+
+    // Read only after construction
+    alignas(SPSC_QUEUE_CACHE_LINE) T* _buffer;
+    size_t _mask;
+};
+
+} // namespace gn
\ No newline at end of file
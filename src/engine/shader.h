@@ -34,8 +34,9 @@ struct Shader
     void SetUniform4fv(const std::string& uniformName, int count, f32* vs);
 
     void SetUniformMatrix4(const std::string& uniformName, bool transpose, const Matrix4& mat);
+    void SetUniformMatrix3x2(const std::string& uniformName, const Matrix3x2& mat);
 
     u32 shaderIDs[(int) Type::NUM_TYPES];
     u32 program { 0 };
-    gn::hash_table<std::string, int, std::hash<std::string>> uniformLocations;
+    gn::hash_table<std::string, int> uniformLocations;
 };
\ No newline at end of file
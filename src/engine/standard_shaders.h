@@ -3,40 +3,69 @@
 constexpr char uiQuadVertShader[] =
 "#version 330 core\n"
 
-"layout(location = 0) in vec3 position;\n"
-"layout(location = 1) in vec2 texCoord;\n"
+// One instance per quad, corners come from gl_VertexID drawn as a 4 vertex strip.
+// Top left, bottom left, top right, bottom right keeps the triangles counter clockwise after the y flip to NDC.
+"layout(location = 0) in vec4 rect;\n"        // left, top, right, bottom in view space
+"layout(location = 1) in vec4 texCoords;\n"   // Coords at the top left and bottom right
 "layout(location = 2) in vec4 color;\n"
-"layout(location = 3) in float texIndex;\n"
+"layout(location = 3) in uvec2 texInfo;\n"    // Texture slot and QuadFlags
 
-"uniform sampler2D u_texs[5];\n"
+"uniform mat3x2 u_transform;\n"
 
+"out vec2 v_position;\n"     // View space
 "out vec2 v_texCoord;\n"
 "out vec4 v_color;\n"
-"out float v_texIndex;\n"
+"flat out uint v_texIndex;\n"
+"flat out uint v_flags;\n"
 
 "void main()\n"
 "{\n"
-"    v_texCoord = texCoord;\n"
+"    vec2 corner = vec2(gl_VertexID >> 1, gl_VertexID & 1);\n"
+"    vec2 position = mix(rect.xy, rect.zw, corner);\n"
+
+"    v_position = position;\n"
+"    v_texCoord = mix(texCoords.xy, texCoords.zw, corner);\n"
 "    v_color = color;\n"
-"    v_texIndex = texIndex;\n"
-"    gl_Position = vec4(position, 1.0);\n"
+"    v_texIndex = texInfo.x;\n"
+"    v_flags = texInfo.y;\n"
+"    gl_Position = vec4(u_transform * vec3(position, 1.0), 0.0, 1.0);\n"
 "}"
 ;
 
 constexpr char uiQuadFragShader[] =
 "#version 330 core\n"
 
+"in vec2 v_position;\n"
 "in vec2 v_texCoord;\n"
 "in vec4 v_color;\n"
-"in float v_texIndex;\n"
+"flat in uint v_texIndex;\n"
+"flat in uint v_flags;\n"
 
-"uniform sampler2D u_texs[5];\n"
+"uniform sampler2D u_texs[MAX_TEXTURES];  // Defined when the shader is loaded\n"
 
 "out vec4 color;\n"
 
 "void main()\n"
 "{\n"
-"    color = v_color * texture(u_texs[int(v_texIndex)], v_texCoord);\n"
+"    vec4 texel = texture(u_texs[v_texIndex], v_texCoord);\n"
+
+// Distance field glyphs, antialiased over about a pixel on screen whatever the scale
+"    if ((v_flags & 1u) != 0u)\n"
+"    {\n"
+"        float width = max(fwidth(texel.a) * 0.75, 0.001);\n"
+"        texel.a = smoothstep(0.5 - width, 0.5 + width, texel.a);\n"
+"    }\n"
+
+// Checkerboard with unit cells, blended to the average shade once a cell is under a pixel
+"    if ((v_flags & 2u) != 0u)\n"
+"    {\n"
+"        vec2 cell = floor(v_position);\n"
+"        float shade = (mod(cell.x + cell.y, 2.0) < 1.0) ? 1.0 : 0.5;\n"
+"        float blend = clamp(2.0 * max(fwidth(v_position.x), fwidth(v_position.y)) - 1.0, 0.0, 1.0);\n"
+"        texel = vec4(vec3(mix(shade, 0.75, blend)), 1.0);\n"
+"    }\n"
+
+"    color = v_color * texel;\n"
 "}"
 ;
 
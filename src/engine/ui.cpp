@@ -1,17 +1,24 @@
 #include "ui.h"
 
 #ifdef DEBUG
-#include <iostream>
+#include <chrono>
 #endif
 
 #include <algorithm>
+#include <filesystem>
+#include <iostream>
 #include <string_view>
+#include <cstring>
+#include <string>
 #include <stb/stb_truetype.h>
 #include <stb/stb_image.h>
 #include <glad/glad.h>
 #include "misc/gn_assert.h"
 #include "platform/application.h"
 #include "platform/fileio.h"
+#include "containers/common_hashes.h"
+#include "containers/darray.h"
+#include "containers/hash_table.h"
 #include "math/types.h"
 #include "shader.h"
 #include "standard_shaders.h"
@@ -20,31 +27,278 @@ namespace UI
 {
 
 static constexpr s32 maxQuadCount = 10000;
-static constexpr s32 maxTexCount = 5;
+static constexpr s32 maxTexCount = 32;  // Upper limit, the driver may allow fewer
+static constexpr f64 caretFrameTime = 1.0 / 30.0;
+
+// Frames are uploaded into a ring of buffer regions, each large enough for a full frame.
+// A region is written again only after the fence placed behind its last draw has signaled.
+static constexpr u32 streamRegionCount = 3;
+
+// Laid out strings kept between frames, labels rarely change from one frame to the next
+static constexpr u32 textLayoutCacheSize = 256;
+
+// Fonts are baked once as signed distance fields at this size and scaled to any size when drawn
+static constexpr f32 sdfPixelHeight = 48.0f;
+static constexpr s32 sdfPadding = 6;                    // Pixels of distance kept around each glyph
+static constexpr u8  sdfOnEdge = 128;
+static constexpr f32 sdfDistanceScale = 128.0f / sdfPadding;
+static constexpr s32 fontAtlasSize = 1024;             // Single channel, room for a few hundred glyphs
+
+// Expanded to 4 corners in the vertex shader, 32 bytes.
+// Positions stay f32, view space is image pixels on the canvas and sheets go well past what 16 bit fixed point covers.
+struct QuadInstance
+{
+    f32 rect[4];            // left, top, right, bottom in view space
+    u16 texCoords[4];       // Normalized, (s, t) at the top left, (u, v) at the bottom right
+    u32 color;              // RGBA8
+    u8  texIndex;
+    u8  flags;              // QuadFlags
+    u8  padding[2];
+};
 
-struct Vertex
+enum QuadFlags : u8
 {
-    Vector3 position;
-    Vector2 texCoord;
-    Vector4 color;
-    f32  texIndex;
+    QUAD_SDF       = 1 << 0,    // Texture alpha is a distance field with the edge at 0.5
+    QUAD_CHECKER   = 1 << 1,    // Checkerboard from the view space position, the texture isn't sampled
 };
 
+static_assert(sizeof(QuadInstance) == 32, "QuadInstance layout has to match the vertex attributes");
+
+// A run of instances drawn with one call, recorded during the frame and drawn when it's submitted
+struct Batch
+{
+    Matrix3x2 transform;
+    u32 first, count;
+    u32 textureCount;
+    u32 textures[maxTexCount];
+};
+
+struct FontGlyph
+{
+    f32 xoff, yoff;         // Top left of the bitmap from the pen, in baked pixels
+    f32 width, height;
+    f32 advance;
+    u16 texCoords[4];       // Packed like QuadInstance
+};
+
+// Glyphs are paged in the first time they're laid out, shelves fill the atlas top to bottom
+struct FontAtlas
+{
+    gn::darray<Byte> fontData;      // stbtt reads outlines from it
+    stbtt_fontinfo info;
+    f32 scale;                      // Font units to baked pixels
+
+    gn::hash_table<u32, FontGlyph> glyphs;
+
+    s32 shelfX, shelfY, shelfHeight;
+};
+
+// A glyph relative to the top left of its text
+struct GlyphQuad
+{
+    f32 rect[4];            // left, top, right, bottom
+    u16 texCoords[4];       // Packed like QuadInstance
+};
+
+struct TextLayout
+{
+    u64 key;
+    u32 fontTexID;          // 0 when the entry is unused
+    std::string text;       // Compared on lookup since keys can collide
+    Vector2 size;
+    gn::darray<GlyphQuad> glyphs;
+
+    u32 prev, next;         // Recency list, most recent first
+};
+
+static constexpr u32 invalidLayout = ~0u;
+
 static struct
 {
-    u32 vao, vbo, ibo;
+    u32 vao, vbo;
     Shader quadShader;
+
+    // Instances are written straight into the mapped write region and hashed on the way,
+    // batches are recorded and drawn when the frame is submitted
+    QuadInstance* frameInstances;       // Start of the write region while mapped
+    u32 frameQuadCount;
+    u64 frameHash;
+    gn::darray<Batch> frameBatches;
+    bool frameCacheable;                // False once part of the frame had to be submitted early
+
     u32 batchQuadCount;
-    Vertex* quadVerticesBuffer, *quadVerticesPtr;
+
+    struct
+    {
+        bool persistent;                // GL_ARB_buffer_storage, mapped once for the whole run
+        QuadInstance* persistentBase;
+        u32 region;                     // Written by the current frame
+        u32 regionUsed;                 // Instances drawn from the current region
+        GLsync fences[streamRegionCount];
+
+        // Last frame drawn from its own region, drawn again from there while the frame stays the same
+        u32 retainedRegion;
+        u32 retainedCount;
+        u64 retainedHash;
+        bool retainedValid;
+    } stream;
 
     u32 batchTextures[maxTexCount];
-    u32 nextActiveTexSlot;  // Should always be lower than max allowed fonts
+    s32 activeSlots[maxTexCount];
+    u32 nextActiveTexSlot;  // Always lower than texSlotCount
+    s32 texSlotCount;
+
+    BatchStats frameStats, lastFrameStats;
 
     ID hot, active;
 
     u32 whiteTextureID;
+
+    Matrix3x2 projection;   // Reference screen pixels to NDC
+    Matrix3x2 view, inverseView;
+
+    struct
+    {
+        TextLayout entries[textLayoutCacheSize];
+        u32 count;
+        u32 head, tail;
+        gn::hash_table<u64, u32> lookup;    // Key to entry index
+    } textCache;
 } uiData;
 
+static void InvalidateTextLayouts(u32 fontTexID);
+static const FontGlyph& GetGlyph(const Font& font, u32 codepoint);
+
+// Byte offset of an instance in a region
+static inline size_t StreamOffset(u32 region, u32 index)
+{
+    return sizeof(QuadInstance) * (region * maxQuadCount + index);
+}
+
+// Expects the stream buffer to be bound to GL_ARRAY_BUFFER
+static void SetInstanceAttributes(size_t offset)
+{
+    glVertexAttribPointer(0, 4, GL_FLOAT, false, sizeof(QuadInstance), (const void*) (offset + offsetof(QuadInstance, rect)));
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_SHORT, true, sizeof(QuadInstance), (const void*) (offset + offsetof(QuadInstance, texCoords)));
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, true, sizeof(QuadInstance), (const void*) (offset + offsetof(QuadInstance, color)));
+    glVertexAttribIPointer(3, 2, GL_UNSIGNED_BYTE, sizeof(QuadInstance), (const void*) (offset + offsetof(QuadInstance, texIndex)));
+}
+
+static void WaitForRegion(u32 region)
+{
+    GLsync& fence = uiData.stream.fences[region];
+    if (!fence)
+        return;
+
+    // Only blocks when the GPU is a whole ring behind
+    while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+// Places the region's fence behind the draws issued so far
+static void FenceRegion(u32 region)
+{
+    GLsync& fence = uiData.stream.fences[region];
+    if (fence)
+        glDeleteSync(fence);
+
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+// Fences the current region and moves on to the next one
+static void NextRegion()
+{
+    if (uiData.stream.regionUsed == 0)
+        return;
+
+    FenceRegion(uiData.stream.region);
+
+    uiData.stream.region = (uiData.stream.region + 1) % streamRegionCount;
+    uiData.stream.regionUsed = 0;
+
+    WaitForRegion(uiData.stream.region);
+}
+
+// Points frameInstances at the start of the write region
+static void MapFrame()
+{
+    uiData.frameHash = 0;
+
+    if (uiData.stream.persistent)
+    {
+        uiData.frameInstances = uiData.stream.persistentBase + uiData.stream.region * maxQuadCount;
+        return;
+    }
+
+    // Nothing the GPU still reads overlaps this range, the fences make sure of that
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+    GLsizeiptr size = sizeof(QuadInstance) * maxQuadCount;
+
+    glBindBuffer(GL_ARRAY_BUFFER, uiData.vbo);
+    uiData.frameInstances = (QuadInstance*) glMapBufferRange(GL_ARRAY_BUFFER, StreamOffset(uiData.stream.region, 0), size, flags);
+}
+
+// The buffer can't be drawn from while a plain mapping is open
+static void UnmapFrame()
+{
+    if (!uiData.stream.persistent && uiData.frameInstances)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, uiData.vbo);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    uiData.frameInstances = nullptr;
+}
+
+// Mapped memory is write combined and slow to read back, so instances are built on the
+// stack, hashed there and then stored
+static inline void WriteInstance(QuadInstance* dest, const QuadInstance& instance)
+{
+    *dest = instance;
+    uiData.frameHash = gn::hash_bytes(&instance, sizeof(QuadInstance), uiData.frameHash);
+}
+
+// The instance hash with the batches folded in
+static u64 HashFrame()
+{
+    u64 hash = uiData.frameHash;
+
+    for (const Batch& batch : uiData.frameBatches)
+    {
+        hash = gn::hash_bytes(batch.transform.data, 6 * sizeof(f32), hash);
+        hash = gn::hash_combine(hash, ((u64) batch.first << 32) | batch.count);
+        hash = gn::hash_bytes(batch.textures, sizeof(u32) * batch.textureCount, hash);
+    }
+
+    return hash;
+}
+
+static void DrawBatches(u32 region)
+{
+    uiData.quadShader.Bind();
+    glBindVertexArray(uiData.vao);
+
+    for (const Batch& batch : uiData.frameBatches)
+    {
+        for (int i = 0; i < batch.textureCount; i++)
+        {
+            glActiveTexture(GL_TEXTURE0 + i);
+            glBindTexture(GL_TEXTURE_2D, batch.textures[i]);
+        }
+
+        uiData.quadShader.SetUniform1iv("u_texs", batch.textureCount, uiData.activeSlots);
+        uiData.quadShader.SetUniformMatrix3x2("u_transform", batch.transform);
+
+        SetInstanceAttributes(StreamOffset(region, batch.first));
+        glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, batch.count);
+
+        uiData.frameStats.drawCalls++;
+        uiData.frameStats.quadCount += batch.count;
+    }
+}
+
 static void InitWhiteTexture(int width, int height)
 {
     u8* pixels = (u8*) malloc(width * height * 4);
@@ -64,99 +318,213 @@ static void InitWhiteTexture(int width, int height)
     free(pixels);
 }
 
+// Sampler arrays need their size when compiling, so it's defined right after the #version line
+static std::string WithTextureCount(const char* source, s32 count)
+{
+    std::string result = source;
+    result.insert(result.find('\n') + 1, "#define MAX_TEXTURES " + std::to_string(count) + "\n");
+    return result;
+}
+
 void Init()
 {
+    GLint maxTextureUnits = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxTextureUnits);
+    uiData.texSlotCount = std::max(1, std::min((s32) maxTextureUnits, maxTexCount));
+
+    for (s32 i = 0; i < maxTexCount; i++)
+        uiData.activeSlots[i] = i;
+
+    std::string fragSource = WithTextureCount(uiQuadFragShader, uiData.texSlotCount);
+
     uiData.quadShader.LoadSource(uiQuadVertShader, Shader::Type::VERTEX_SHADER);
-    uiData.quadShader.LoadSource(uiQuadFragShader, Shader::Type::FRAGMENT_SHADER);
+    uiData.quadShader.LoadSource(fragSource.c_str(), Shader::Type::FRAGMENT_SHADER);
     uiData.quadShader.Compile();
 
-    uiData.quadVerticesBuffer = new Vertex[maxQuadCount * 4];
-
     glGenVertexArrays(1, &uiData.vao);
     glBindVertexArray(uiData.vao);
 
     glGenBuffers(1, &uiData.vbo);
     glBindBuffer(GL_ARRAY_BUFFER, uiData.vbo);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * maxQuadCount * 4, nullptr, GL_DYNAMIC_DRAW);
-
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, false, sizeof(Vertex), (const void*) offsetof(Vertex, position));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, false, sizeof(Vertex), (const void*) offsetof(Vertex, texCoord));
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 4, GL_FLOAT, false, sizeof(Vertex), (const void*) offsetof(Vertex, color));
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 1, GL_FLOAT, false, sizeof(Vertex), (const void*) offsetof(Vertex, texIndex));
-
-    u32 indices[maxQuadCount * 6];
-    u32 offset = 0;
-    for (int i = 0; i < maxQuadCount * 6; i += 6)
+
+    GLsizeiptr streamSize = sizeof(QuadInstance) * maxQuadCount * streamRegionCount;
+    uiData.stream.persistent = GLAD_GL_VERSION_4_4 || GLAD_GL_ARB_buffer_storage;
+
+    if (uiData.stream.persistent)
     {
-        indices[i + 0] = offset + 0;
-        indices[i + 1] = offset + 1;
-        indices[i + 2] = offset + 2;
-        indices[i + 3] = offset + 2;
-        indices[i + 4] = offset + 3;
-        indices[i + 5] = offset + 0;
-        offset += 4;
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_ARRAY_BUFFER, streamSize, nullptr, flags);
+        uiData.stream.persistentBase = (QuadInstance*) glMapBufferRange(GL_ARRAY_BUFFER, 0, streamSize, flags);
     }
+    else
+        glBufferData(GL_ARRAY_BUFFER, streamSize, nullptr, GL_STREAM_DRAW);
+
+    for (u32 i = 0; i <= 3; i++)
+        glEnableVertexAttribArray(i);
+
+    SetInstanceAttributes(0);
+
+    // Every attribute advances once per quad
+    for (u32 i = 0; i <= 3; i++)
+        glVertexAttribDivisor(i, 1);
 
-    glGenBuffers(1, &uiData.ibo);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, uiData.ibo);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    uiData.frameInstances = nullptr;
+    uiData.frameQuadCount = 0;
 
     uiData.batchQuadCount = 0;
     uiData.nextActiveTexSlot = 0;
 
     uiData.hot = uiData.active = UIInvalid();
 
+    uiData.textCache.count = 0;
+    uiData.textCache.head = uiData.textCache.tail = invalidLayout;
+
     InitWhiteTexture(32, 32);
 
     stbi_set_flip_vertically_on_load(true);
 }
 
-void Begin()
+static void ResetBatch()
 {
     uiData.batchQuadCount = 0;
     uiData.nextActiveTexSlot = 0;
-    uiData.quadVerticesPtr = uiData.quadVerticesBuffer;
-
-    glDisable(GL_DEPTH_TEST);
 }
 
-void End()
+// Ends the current batch, it's drawn when the frame is submitted
+static void Flush()
 {
     if (uiData.batchQuadCount == 0)
         return;
 
-    uiData.quadShader.Bind();
+    Batch& batch = uiData.frameBatches.emplace_back();
+    batch.transform = uiData.projection * uiData.view;
+    batch.first = uiData.frameQuadCount - uiData.batchQuadCount;
+    batch.count = uiData.batchQuadCount;
+    batch.textureCount = uiData.nextActiveTexSlot;
+    memcpy(batch.textures, uiData.batchTextures, sizeof(u32) * batch.textureCount);
 
-    for (int i = 0; i < uiData.nextActiveTexSlot; i++)
+    ResetBatch();
+}
+
+// Draws everything recorded so far. When the frame matches the retained one, which is the
+// usual case while idle, it's drawn from the retained region and the write region is left
+// unfenced for the next frame.
+static void SubmitFrame()
+{
+    Flush();
+    UnmapFrame();
+
+    if (uiData.frameQuadCount == 0)
+        return;
+
+    glBindBuffer(GL_ARRAY_BUFFER, uiData.vbo);
+
+    u64 hash = HashFrame();
+    bool unchanged = uiData.frameCacheable && uiData.stream.retainedValid &&
+                     uiData.stream.retainedHash == hash &&
+                     uiData.stream.retainedCount == uiData.frameQuadCount;
+
+    if (unchanged)
     {
-        glActiveTexture(GL_TEXTURE0 + i);
-        glBindTexture(GL_TEXTURE_2D, uiData.batchTextures[i]);
+        DrawBatches(uiData.stream.retainedRegion);
+        FenceRegion(uiData.stream.retainedRegion);
+        uiData.frameStats.reusedUpload = true;
     }
+    else
+    {
+        DrawBatches(uiData.stream.region);
 
-    s32 activeSlots[maxTexCount] { 0, 1, 2, 3, 4 };
-    uiData.quadShader.SetUniform1iv("u_texs", uiData.nextActiveTexSlot, activeSlots);
+        uiData.stream.retainedRegion = uiData.stream.region;
+        uiData.stream.retainedCount = uiData.frameQuadCount;
+        uiData.stream.retainedHash = hash;
+        uiData.stream.retainedValid = uiData.frameCacheable;
 
-    glBindVertexArray(uiData.vao);
+        uiData.stream.regionUsed = uiData.frameQuadCount;
+        uiData.frameStats.bytesUploaded += sizeof(QuadInstance) * uiData.frameQuadCount;
+        NextRegion();
+    }
 
-    // Update Data
-    GLsizeiptr size = (u8*)uiData.quadVerticesPtr - (u8*)uiData.quadVerticesBuffer;
-    glBindBuffer(GL_ARRAY_BUFFER, uiData.vbo);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, size, uiData.quadVerticesBuffer);
+    uiData.frameQuadCount = 0;
+    uiData.frameBatches.clear();
+}
+
+void Begin(const Application& app)
+{
+    ResetBatch();
+    uiData.frameQuadCount = 0;
+    uiData.frameBatches.clear();
+    uiData.frameCacheable = true;
+    uiData.frameStats = BatchStats {};
+    MapFrame();
+
+    uiData.projection = Matrix3x2::ScreenToNDC((f32) app.refScreenWidth, (f32) app.refScreenHeight);
+    uiData.view = uiData.inverseView = Matrix3x2();
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, uiData.ibo);
-    glDrawElements(GL_TRIANGLES, 6 * uiData.batchQuadCount, GL_UNSIGNED_INT, nullptr);
+    glDisable(GL_DEPTH_TEST);
+}
+
+void End()
+{
+    SubmitFrame();
+    uiData.lastFrameStats = uiData.frameStats;
 
     glEnable(GL_DEPTH_TEST);
 }
 
+void SetViewMatrix(const Matrix3x2& view)
+{
+    if (memcmp(view.data, uiData.view.data, 6 * sizeof(f32)) == 0)
+        return;
+
+    if (uiData.batchQuadCount > 0)
+        uiData.frameStats.viewFlushes++;
+
+    Flush();
+
+    uiData.view = view;
+    uiData.inverseView = Inverse(view);
+}
+
+const Matrix3x2& GetViewMatrix()
+{
+    return uiData.view;
+}
+
+const BatchStats& GetLastFrameStats()
+{
+    return uiData.lastFrameStats;
+}
+
+s32 GetTextureSlotCount()
+{
+    return uiData.texSlotCount;
+}
+
+// Mouse position in the space of the current view
+static Vector2 MousePosition(const Application& app)
+{
+    return uiData.inverseView * Vector2((f32) app.mouseX, (f32) app.mouseY);
+}
+
 void Shutdown()
 {
     glDeleteTextures(1, &uiData.whiteTextureID);
-    delete[] uiData.quadVerticesBuffer;
+    UnmapFrame();
+
+    if (uiData.stream.persistent)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, uiData.vbo);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+
+    for (GLsync fence : uiData.stream.fences)
+    {
+        if (fence)
+            glDeleteSync(fence);
+    }
+
+    glDeleteBuffers(1, &uiData.vbo);
+    glDeleteVertexArrays(1, &uiData.vao);
 }
 
 bool ID::operator==(const ID& other) const
@@ -169,44 +537,227 @@ bool ID::operator!=(const ID& other) const
     return primary != other.primary || secondary != other.secondary;
 }
 
-void Font::Load(const std::string_view& filepath, f32 height)
+// Baked atlases are saved to the user's cache directory and read back on later launches.
+// The key covers everything that changes the bake, a mismatch just bakes again.
+static constexpr u32 fontCacheMagic = 0x41464E47;     // "GNFA"
+static constexpr u32 fontCacheVersion = 1;
+static constexpr u32 fontCacheFirstCodepoint = ' ';
+static constexpr u32 fontCacheLastCodepoint = 127;
+
+struct FontCacheHeader
+{
+    u32 magic;
+    u32 version;
+    u64 key;
+    u32 glyphCount;
+    s32 shelfX, shelfY, shelfHeight;
+};
+
+// Followed by glyphCount CachedGlyphs, then the used rows of the atlas
+struct CachedGlyph
+{
+    u32 codepoint;
+    FontGlyph glyph;
+};
+
+static u64 FontCacheKey(const FontAtlas& atlas)
+{
+    f32 bakeSettings[] = { sdfPixelHeight, (f32) sdfPadding, (f32) sdfOnEdge, sdfDistanceScale, (f32) fontAtlasSize,
+                           (f32) fontCacheFirstCodepoint, (f32) fontCacheLastCodepoint };
+
+    u64 key = gn::hash_bytes(atlas.fontData.data(), atlas.fontData.size(), fontCacheVersion);
+    return gn::hash_bytes(bakeSettings, sizeof(bakeSettings), key);
+}
+
+// Reads the header, glyphs and rows straight from the mapping
+static bool ReadFontCache(const MappedFile& file, u64 key, FontAtlas& atlas)
+{
+    if (file.size < sizeof(FontCacheHeader))
+        return false;
+
+    FontCacheHeader header;
+    memcpy(&header, file.data, sizeof(header));
+
+    if (header.magic != fontCacheMagic || header.version != fontCacheVersion || header.key != key)
+        return false;
+
+    s32 rows = header.shelfY + header.shelfHeight;
+    size_t glyphsSize = sizeof(CachedGlyph) * header.glyphCount;
+
+    if (rows < 0 || rows > fontAtlasSize ||
+        file.size != sizeof(header) + glyphsSize + (size_t) rows * fontAtlasSize)
+        return false;
+
+    const Byte* glyphs = file.data + sizeof(header);
+    for (u32 i = 0; i < header.glyphCount; i++)
+    {
+        CachedGlyph cached;
+        memcpy(&cached, glyphs + i * sizeof(CachedGlyph), sizeof(cached));
+        atlas.glyphs[cached.codepoint] = cached.glyph;
+    }
+
+    if (rows > 0)
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, fontAtlasSize, rows, GL_RED, GL_UNSIGNED_BYTE, glyphs + glyphsSize);
+
+    atlas.shelfX = header.shelfX;
+    atlas.shelfY = header.shelfY;
+    atlas.shelfHeight = header.shelfHeight;
+
+    return true;
+}
+
+// Expects the atlas texture to be bound. The file is mapped so the atlas rows are uploaded
+// from the page cache without going through a buffer of our own.
+static bool LoadFontCache(const std::string& cachePath, u64 key, FontAtlas& atlas)
+{
+    MappedFile file;
+    if (!file.Map(cachePath))
+        return false;
+
+    bool loaded = ReadFontCache(file, key, atlas);
+    file.Unmap();
+
+    return loaded;
+}
+
+// Expects the atlas texture to be bound. Failing to save isn't an error, the atlas is baked again next launch
+static bool SaveFontCache(const std::string& cachePath, u64 key, const FontAtlas& atlas)
 {
-    constexpr int BITMAP_SIZE = 256;
+    FontCacheHeader header;
+    header.magic = fontCacheMagic;
+    header.version = fontCacheVersion;
+    header.key = key;
+    header.glyphCount = (u32) atlas.glyphs.size();
+    header.shelfX = atlas.shelfX;
+    header.shelfY = atlas.shelfY;
+    header.shelfHeight = atlas.shelfHeight;
+
+    size_t rows = (size_t) (header.shelfY + header.shelfHeight);
+    size_t glyphsSize = sizeof(CachedGlyph) * header.glyphCount;
+
+    gn::darray<Byte> contents;
+    contents.resize(sizeof(header) + glyphsSize + fontAtlasSize * fontAtlasSize);
+    memcpy(contents.data(), &header, sizeof(header));
+
+    Byte* glyphs = contents.data() + sizeof(header);
+    for (const auto& pair : atlas.glyphs)
+    {
+        CachedGlyph cached { pair.key, pair.value };
+        memcpy(glyphs, &cached, sizeof(cached));
+        glyphs += sizeof(cached);
+    }
 
-    auto contents = LoadBinaryFile(filepath);
+    // Read back whole, only the rows holding glyphs are written out
+    glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_UNSIGNED_BYTE, glyphs);
 
-    Byte* bitmap = (Byte*) malloc(BITMAP_SIZE * BITMAP_SIZE * 5);
-    stbtt_BakeFontBitmap(contents.data(), 0, height, bitmap, BITMAP_SIZE, BITMAP_SIZE, ' ', 128 - ' ', charData);
+    return SaveBinaryFile(cachePath, contents.data(), sizeof(header) + glyphsSize + rows * fontAtlasSize);
+}
+
+bool Font::Load(const std::string_view& filepath, f32 height)
+{
+#   ifdef DEBUG
+    auto startTime = std::chrono::steady_clock::now();
+#   endif
 
-    // Make a separate texture setting the alpha value as the bitmap value and rest are 1.0f
-    Byte* pixels = bitmap + (BITMAP_SIZE * BITMAP_SIZE);
-    for (int i = 0; i < BITMAP_SIZE * BITMAP_SIZE; i++)
+    atlas = new FontAtlas();
+    atlas->fontData = LoadBinaryFile(filepath);
+
+    fontHeight = height;
+
+    // A corrupt or unsupported file leaves the font without an atlas, text drawn with it is skipped
+    int offset = stbtt_GetFontOffsetForIndex(atlas->fontData.data(), 0);
+    if (offset < 0 || !stbtt_InitFont(&atlas->info, atlas->fontData.data(), offset))
     {
-        pixels[4 * i + 0] = 255;
-        pixels[4 * i + 1] = 255;
-        pixels[4 * i + 2] = 255;
-        pixels[4 * i + 3] = bitmap[i];
+        std::cout << "Couldn't read the font " << filepath << "\n";
+
+        delete atlas;
+        atlas = nullptr;
+        bitmapTexID = 0;
+        bitmapWidth = bitmapHeight = 0;
+
+        return false;
     }
 
+    atlas->scale = stbtt_ScaleForPixelHeight(&atlas->info, sdfPixelHeight);
+    atlas->shelfX = atlas->shelfY = atlas->shelfHeight = 0;
+
+#   ifdef DEBUG
+    auto readTime = std::chrono::steady_clock::now();
+#   endif
+
+    // Cleared so filtering never picks up garbage between glyphs
+    Byte* zeroes = (Byte*) calloc(fontAtlasSize * fontAtlasSize, 1);
+
     glGenTextures(1, &bitmapTexID);
     glBindTexture(GL_TEXTURE_2D, bitmapTexID);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, BITMAP_SIZE, BITMAP_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
-    glGenerateMipmap(GL_TEXTURE_2D);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, fontAtlasSize, fontAtlasSize, 0, GL_RED, GL_UNSIGNED_BYTE, zeroes);
 
+    // Sampled as white with the distance in alpha, the same as the other textures
+    GLint swizzle[] = { GL_ONE, GL_ONE, GL_ONE, GL_RED };
+    glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+
+    // No mipmaps, glyphs are added after the texture is made and the distance field filters fine
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
-    bitmapWidth = bitmapHeight = BITMAP_SIZE;
-    fontHeight  = height;
+    free(zeroes);
+
+    bitmapWidth = bitmapHeight = fontAtlasSize;
+
+    // Printable ASCII is baked up front, or read from the cache, everything else when it's first drawn
+    // Named after the font file, a different font with the same name just fails the key check and bakes again
+    std::string cacheDirectory = GetCacheDirectory();
+    std::string cachePath;
 
-    free(bitmap);
+    if (!cacheDirectory.empty())
+        cachePath = cacheDirectory + "/" + std::filesystem::path(filepath).filename().string() + ".atlas";
+
+    u64 cacheKey = FontCacheKey(*atlas);
+
+    bool cached = !cachePath.empty() && LoadFontCache(cachePath, cacheKey, *atlas);
+    if (!cached)
+    {
+        for (u32 codepoint = fontCacheFirstCodepoint; codepoint <= fontCacheLastCodepoint; codepoint++)
+            GetGlyph(*this, codepoint);
+
+        glBindTexture(GL_TEXTURE_2D, bitmapTexID);
+
+        if (cachePath.empty() || !SaveFontCache(cachePath, cacheKey, *atlas))
+        {
+#           ifdef DEBUG
+            std::cout << "Couldn't save the font atlas cache for " << filepath << "\n";
+#           endif
+        }
+    }
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+#   ifdef DEBUG
+    auto endTime = std::chrono::steady_clock::now();
+    auto ms = [](auto from, auto to) { return std::chrono::duration<f64, std::milli>(to - from).count(); };
+
+    std::cout << "Font " << filepath << ": read " << ms(startTime, readTime) << "ms, "
+              << (cached ? "atlas from cache " : "atlas baked ") << ms(readTime, endTime) << "ms\n";
+#   endif
+
+    return true;
 }
 
 void Font::Free()
 {
+    if (!atlas)
+        return;
+
+    InvalidateTextLayouts(bitmapTexID);
     glDeleteTextures(1, &bitmapTexID);
+
+    delete atlas;
+    atlas = nullptr;
 }
 
 void Image::SetScale(const Vector2& scale)
@@ -217,15 +768,14 @@ void Image::SetScale(const Vector2& scale)
 
 bool Image::Load(const std::string_view& filepath)
 {
-    s32 bytesPP;
-    pixels = stbi_load(filepath.data(), &width, &height, &bytesPP, 0);
+    pixels = stbi_load(filepath.data(), &width, &height, &channels, 0);
     ASSERT(pixels != nullptr);
 
     if (pixels == nullptr)
         return false;
 
     int internalFormat, format;
-    switch (bytesPP)
+    switch (channels)
     {
         case 3:
         {
@@ -282,21 +832,38 @@ bool SomethingIsActive()
     return uiData.active != UIInvalid();
 }
 
-static void AddTexturedQuad(Application& app, const Rect& rect, Vector4 texCoords, u32 texID, Vector4 color)
+static inline u32 PackColor(const Vector4& color)
 {
-    if (uiData.batchQuadCount >= maxQuadCount)
-    {
-        End();
-        Begin();
-    }
+    u32 r = (u32) (Clamp(color.r, 0.0f, 1.0f) * 255.0f + 0.5f);
+    u32 g = (u32) (Clamp(color.g, 0.0f, 1.0f) * 255.0f + 0.5f);
+    u32 b = (u32) (Clamp(color.b, 0.0f, 1.0f) * 255.0f + 0.5f);
+    u32 a = (u32) (Clamp(color.a, 0.0f, 1.0f) * 255.0f + 0.5f);
 
-    f32 top    = 1.0f - 2.0f * (rect.topLeft.y / app.refScreenHeight);
-    f32 left   = 2.0f * (rect.topLeft.x / app.refScreenWidth) - 1.0f;
-    f32 right  = 2.0f * ((rect.topLeft.x + rect.size.x) / app.refScreenWidth) - 1.0f;
-    f32 bottom = 1.0f - 2.0f * ((rect.topLeft.y + rect.size.y) / app.refScreenHeight);
+    // Bytes in memory are r, g, b, a
+    return r | (g << 8) | (b << 16) | (a << 24);
+}
 
-    f32 z = rect.topLeft.z;
+static inline u16 PackTexCoord(f32 coord)
+{
+    return (u16) (Clamp(coord, 0.0f, 1.0f) * 65535.0f + 0.5f);
+}
 
+// Makes room for count more quads, count can't be more than maxQuadCount
+static void ReserveQuads(u32 count)
+{
+    // A frame that doesn't fit is drawn in parts and can't be reused
+    if (uiData.frameQuadCount + count > maxQuadCount)
+    {
+        uiData.frameStats.bufferFlushes++;
+        uiData.frameCacheable = false;
+        SubmitFrame();
+        MapFrame();
+    }
+}
+
+// Slot of the texture in the current batch, call after reserving the quads that use it
+static u8 GetTextureSlot(u32 texID)
+{
     // Find if texture has already been set to active
     int textureSlot = uiData.nextActiveTexSlot;
     for (int i = 0; i < uiData.nextActiveTexSlot; i++)
@@ -310,42 +877,48 @@ static void AddTexturedQuad(Application& app, const Rect& rect, Vector4 texCoord
 
     if (textureSlot == uiData.nextActiveTexSlot)
     {
-#       ifdef DEBUG
-        if (uiData.nextActiveTexSlot >= maxTexCount)
+        // Out of slots, draw what's there and start the next batch with this texture
+        if (uiData.nextActiveTexSlot >= uiData.texSlotCount)
         {
-            std::cout << "Only " << maxTexCount << " textures allowed in a batch\n";
-            return;
+            uiData.frameStats.textureFlushes++;
+            Flush();
+            textureSlot = 0;
         }
-#       endif
 
         uiData.batchTextures[textureSlot] = texID;
         uiData.nextActiveTexSlot++;
     }
 
-    uiData.quadVerticesPtr->position = Vector3(left, bottom, z);
-    uiData.quadVerticesPtr->color = color;
-    uiData.quadVerticesPtr->texCoord = Vector2(texCoords.s, texCoords.v);
-    uiData.quadVerticesPtr->texIndex = (f32) textureSlot;
-    uiData.quadVerticesPtr++;
-
-    uiData.quadVerticesPtr->position = Vector3(right, bottom, z);
-    uiData.quadVerticesPtr->color = color;
-    uiData.quadVerticesPtr->texCoord = Vector2(texCoords.u, texCoords.v);
-    uiData.quadVerticesPtr->texIndex = (f32) textureSlot;
-    uiData.quadVerticesPtr++;
-
-    uiData.quadVerticesPtr->position = Vector3(right, top, z);
-    uiData.quadVerticesPtr->color = color;
-    uiData.quadVerticesPtr->texCoord = Vector2(texCoords.u, texCoords.t);
-    uiData.quadVerticesPtr->texIndex = (f32) textureSlot;
-    uiData.quadVerticesPtr++;
-
-    uiData.quadVerticesPtr->position = Vector3(left, top, z);
-    uiData.quadVerticesPtr->color = color;
-    uiData.quadVerticesPtr->texCoord = Vector2(texCoords.s, texCoords.t);
-    uiData.quadVerticesPtr->texIndex = (f32) textureSlot;
-    uiData.quadVerticesPtr++;
+    return (u8) textureSlot;
+}
+
+static void AddTexturedQuad(Application& app, const Rect& rect, Vector4 texCoords, u32 texID, Vector4 color, u8 flags = 0)
+{
+    ReserveQuads(1);
+
+    // Positions stay in view space, the vertex shader applies the view and projection
+    f32 top    = rect.topLeft.y;
+    f32 left   = rect.topLeft.x;
+    f32 right  = rect.topLeft.x + rect.size.x;
+    f32 bottom = rect.topLeft.y + rect.size.y;
+
+    u8 textureSlot = GetTextureSlot(texID);
+
+    QuadInstance instance;
+    instance.rect[0] = left;
+    instance.rect[1] = top;
+    instance.rect[2] = right;
+    instance.rect[3] = bottom;
+
+    for (int i = 0; i < 4; i++)
+        instance.texCoords[i] = PackTexCoord(texCoords.data[i]);
+
+    instance.color = PackColor(color);
+    instance.texIndex = textureSlot;
+    instance.flags = flags;
+    instance.padding[0] = instance.padding[1] = 0;     // Hashed with the rest
 
+    WriteInstance(&uiData.frameInstances[uiData.frameQuadCount++], instance);
     uiData.batchQuadCount++;
 }
 
@@ -355,10 +928,122 @@ static inline void AddColouredQuad(Application& app, const Rect& rect, Vector4 c
     AddTexturedQuad(app, rect, texCoords, uiData.whiteTextureID, color);
 }
 
-Vector2 GetRenderedTextSize(const std::string_view& text, const Font& font)
+// Bakes the glyph's distance field into the next free spot of the atlas
+static bool BakeGlyph(const Font& font, u32 codepoint, FontGlyph& glyph)
+{
+    FontAtlas& atlas = *font.atlas;
+
+    int advance, leftBearing;
+    stbtt_GetCodepointHMetrics(&atlas.info, codepoint, &advance, &leftBearing);
+
+    int width = 0, height = 0, xoff = 0, yoff = 0;
+    Byte* sdf = stbtt_GetCodepointSDF(&atlas.info, atlas.scale, codepoint, sdfPadding, sdfOnEdge, sdfDistanceScale,
+                                      &width, &height, &xoff, &yoff);
+
+    glyph = FontGlyph {};
+    glyph.advance = advance * atlas.scale;
+
+    // Blank glyphs like space have no bitmap
+    if (!sdf)
+        return true;
+
+    // Next shelf, with a pixel between glyphs so filtering doesn't bleed
+    if (atlas.shelfX + width > fontAtlasSize)
+    {
+        atlas.shelfX = 0;
+        atlas.shelfY += atlas.shelfHeight + 1;
+        atlas.shelfHeight = 0;
+    }
+
+    if (atlas.shelfY + height > fontAtlasSize)
+    {
+        stbtt_FreeSDF(sdf, nullptr);
+        return false;
+    }
+
+    s32 x = atlas.shelfX, y = atlas.shelfY;
+    atlas.shelfX += width + 1;
+    atlas.shelfHeight = std::max(atlas.shelfHeight, height);
+
+    glBindTexture(GL_TEXTURE_2D, font.bitmapTexID);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, width, height, GL_RED, GL_UNSIGNED_BYTE, sdf);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    stbtt_FreeSDF(sdf, nullptr);
+
+    glyph.xoff   = (f32) xoff;
+    glyph.yoff   = (f32) yoff;
+    glyph.width  = (f32) width;
+    glyph.height = (f32) height;
+
+    glyph.texCoords[0] = PackTexCoord((f32) x / fontAtlasSize);
+    glyph.texCoords[1] = PackTexCoord((f32) y / fontAtlasSize);
+    glyph.texCoords[2] = PackTexCoord((f32) (x + width) / fontAtlasSize);
+    glyph.texCoords[3] = PackTexCoord((f32) (y + height) / fontAtlasSize);
+
+    return true;
+}
+
+// Missing glyphs and ones that don't fit in the atlas anymore show up as '?'
+static const FontGlyph& GetGlyph(const Font& font, u32 codepoint)
+{
+    FontAtlas& atlas = *font.atlas;
+
+    auto it = atlas.glyphs.find(codepoint);
+    if (it != atlas.glyphs.end())
+        return (*it).value;
+
+    FontGlyph glyph;
+    bool inFont = stbtt_FindGlyphIndex(&atlas.info, codepoint) != 0;
+
+    if (!inFont || !BakeGlyph(font, codepoint, glyph))
+    {
+#       ifdef DEBUG
+        if (inFont)
+            std::cout << "Font atlas is full, U+" << std::hex << codepoint << std::dec << " is drawn as '?'\n";
+#       endif
+
+        glyph = (codepoint == '?') ? FontGlyph {} : GetGlyph(font, '?');
+    }
+
+    atlas.glyphs[codepoint] = glyph;
+    return atlas.glyphs[codepoint];
+}
+
+// Invalid bytes are returned as they are so ASCII and Latin-1 text still lays out
+static u32 DecodeUTF8(const std::string_view& text, int& i)
 {
+    u8 lead = (u8) text[i];
+
+    int length = (lead >= 0xF0) ? 4 : (lead >= 0xE0) ? 3 : (lead >= 0xC0) ? 2 : 1;
+    if (length == 1 || i + length > text.length())
+        return lead;
+
+    u32 codepoint = lead & (0x7F >> length);
+    for (int j = 1; j < length; j++)
+    {
+        u8 next = (u8) text[i + j];
+        if ((next & 0xC0) != 0x80)
+            return lead;
+
+        codepoint = (codepoint << 6) | (next & 0x3F);
+    }
+
+    i += length - 1;
+    return codepoint;
+}
+
+// Same rules RenderText used to follow, glyphs are placed relative to (0, 0)
+static void LayoutText(const std::string_view& text, const Font& font, TextLayout& layout)
+{
+    layout.glyphs.clear();
+
+    // Baked pixels to the font's size
+    f32 scale = font.fontHeight / sdfPixelHeight;
+
     Vector2 size { 0.0f, font.fontHeight * 0.75f };
-    f32 lineX = 0.0f;
+    Vector2 position { 0.0f, font.fontHeight * 0.65f };
 
     int lineStart = 0;
     for (int i = 0; i < text.length(); i++)
@@ -366,36 +1051,152 @@ Vector2 GetRenderedTextSize(const std::string_view& text, const Font& font)
         if (text[i] == '\n')
         {
             size.y += font.fontHeight;
-            size.x = std::max(lineX, size.x);
-            lineX = 0.0f;
+            size.x = std::max(position.x, size.x);
+            position.y += font.fontHeight;
+            position.x = 0.0f;
             lineStart = i + 1;
             continue;
         }
 
         if (text[i] == '\r')
         {
-            size.x = std::max(lineX, size.x);
-            lineX = 0.0f;
+            size.x = std::max(position.x, size.x);
+            position.x = 0.0f;
             continue;
         }
-        
+
         if (text[i] == '\t')
         {
-            f32 x = 0.0f, y = 0.0f;
-            stbtt_aligned_quad quad;
-            stbtt_GetBakedQuad(font.charData, font.bitmapWidth, font.bitmapHeight, 0,   // That's the index for space
-                           &x, &y, &quad, 1);
-            lineX += x * (4 - ((i - lineStart) % 4));
+            position.x += GetGlyph(font, ' ').advance * scale * (4 - ((i - lineStart) % 4));
             continue;
         }
 
-        stbtt_aligned_quad quad;
-        stbtt_GetBakedQuad(font.charData, font.bitmapWidth, font.bitmapHeight, text[i] - ' ',
-                           &lineX, &size.y, &quad, 1);
+        const FontGlyph& glyph = GetGlyph(font, DecodeUTF8(text, i));
+
+        if (glyph.width > 0.0f)
+        {
+            GlyphQuad& quad = layout.glyphs.emplace_back();
+            quad.rect[0] = position.x + glyph.xoff * scale;
+            quad.rect[1] = position.y + glyph.yoff * scale;
+            quad.rect[2] = quad.rect[0] + glyph.width  * scale;
+            quad.rect[3] = quad.rect[1] + glyph.height * scale;
+
+            memcpy(quad.texCoords, glyph.texCoords, sizeof(quad.texCoords));
+        }
+
+        position.x += glyph.advance * scale;
+    }
+
+    size.x = std::max(position.x, size.x);
+    layout.size = size;
+}
+
+static void UnlinkLayout(u32 index)
+{
+    TextLayout& layout = uiData.textCache.entries[index];
+
+    if (layout.prev != invalidLayout)
+        uiData.textCache.entries[layout.prev].next = layout.next;
+    else
+        uiData.textCache.head = layout.next;
+
+    if (layout.next != invalidLayout)
+        uiData.textCache.entries[layout.next].prev = layout.prev;
+    else
+        uiData.textCache.tail = layout.prev;
+}
+
+static void PushLayoutFront(u32 index)
+{
+    TextLayout& layout = uiData.textCache.entries[index];
+    layout.prev = invalidLayout;
+    layout.next = uiData.textCache.head;
+
+    if (uiData.textCache.head != invalidLayout)
+        uiData.textCache.entries[uiData.textCache.head].prev = index;
+    else
+        uiData.textCache.tail = index;
+
+    uiData.textCache.head = index;
+}
+
+// Lays the text out once and hands back the same layout until it's evicted
+static const TextLayout& GetTextLayout(const std::string_view& text, const Font& font)
+{
+    // Fonts that failed to load have nothing to lay out with
+    if (!font.atlas)
+    {
+        static const TextLayout empty {};
+        return empty;
+    }
+
+    auto& cache = uiData.textCache;
+    u64 key = gn::hash_bytes(text.data(), text.length(), font.bitmapTexID);
+
+    u32 index = invalidLayout;
+
+    auto it = cache.lookup.find(key);
+    if (it != cache.lookup.end())
+    {
+        index = (*it).value;
+
+        TextLayout& layout = cache.entries[index];
+        if (layout.key == key && layout.fontTexID == font.bitmapTexID && layout.text == text)
+        {
+            if (cache.head != index)
+            {
+                UnlinkLayout(index);
+                PushLayoutFront(index);
+            }
+
+            return layout;
+        }
+
+        // Collision, the entry is laid out again for this text
+        UnlinkLayout(index);
+    }
+    else if (cache.count < textLayoutCacheSize)
+        index = cache.count++;
+    else
+    {
+        // Evict the least recently used
+        index = cache.tail;
+        UnlinkLayout(index);
+
+        if (cache.entries[index].fontTexID != 0)
+            cache.lookup.erase(cache.entries[index].key);
+    }
+
+    TextLayout& layout = cache.entries[index];
+    layout.key = key;
+    layout.fontTexID = font.bitmapTexID;
+    layout.text = text;
+    LayoutText(text, font, layout);
+
+    cache.lookup[key] = index;
+    PushLayoutFront(index);
+
+    return layout;
+}
+
+// Drops the font's layouts, its texture ID can be handed out again
+static void InvalidateTextLayouts(u32 fontTexID)
+{
+    for (u32 i = 0; i < uiData.textCache.count; i++)
+    {
+        TextLayout& layout = uiData.textCache.entries[i];
+        if (layout.fontTexID != fontTexID)
+            continue;
+
+        uiData.textCache.lookup.erase(layout.key);
+        layout.fontTexID = 0;
+        layout.text.clear();
     }
+}
 
-    size.x = std::max(lineX, size.x);
-    return size;
+Vector2 GetRenderedTextSize(const std::string_view& text, const Font& font)
+{
+    return GetTextLayout(text, font).size;
 }
 
 void RenderRect(Application& app, const Rect& rect, Vector4 color)
@@ -406,47 +1207,40 @@ void RenderRect(Application& app, const Rect& rect, Vector4 color)
 void RenderText(Application& app, const std::string_view& text, const Font& font,
                 Vector4 color, Vector3 topLeft)
 {
-    Vector2 position { topLeft.x, topLeft.y };
-    position.y += font.fontHeight * 0.65f;
+    const TextLayout& layout = GetTextLayout(text, font);
+    u32 packedColor = PackColor(color);
 
-    int lineStart = 0;
-    for (int i = 0; i < text.length(); i++)
+    // Written straight into the frame, the texture slot is found once per run of glyphs
+    for (u32 first = 0; first < layout.glyphs.size(); first += maxQuadCount)
     {
-        if (text[i] == '\n')
-        {
-            position.y += font.fontHeight;
-            position.x = topLeft.x;
-            lineStart = i + 1;
-            continue;
-        }
+        u32 count = std::min((u32) layout.glyphs.size() - first, (u32) maxQuadCount);
 
-        if (text[i] == '\r')
-        {
-            position.x = topLeft.x;
-            continue;
-        }
-        
-        if (text[i] == '\t')
+        ReserveQuads(count);
+        u8 textureSlot = GetTextureSlot(font.bitmapTexID);
+
+        QuadInstance* instances = uiData.frameInstances + uiData.frameQuadCount;
+        for (u32 i = 0; i < count; i++)
         {
-            f32 x = 0.0f, y = 0.0f;
-            stbtt_aligned_quad quad;
-            stbtt_GetBakedQuad(font.charData, font.bitmapWidth, font.bitmapHeight, 0,   // That's the index for space
-                           &x, &y, &quad, 1);
-            position.x += x * (4 - ((i - lineStart) % 4));
-            continue;
-        }
+            const GlyphQuad& glyph = layout.glyphs[first + i];
+            QuadInstance instance;
+
+            instance.rect[0] = topLeft.x + glyph.rect[0];
+            instance.rect[1] = topLeft.y + glyph.rect[1];
+            instance.rect[2] = topLeft.x + glyph.rect[2];
+            instance.rect[3] = topLeft.y + glyph.rect[3];
 
-        stbtt_aligned_quad quad;
-        stbtt_GetBakedQuad(font.charData, font.bitmapWidth, font.bitmapHeight, text[i] - ' ',
-                           &position.x, &position.y, &quad, 1);
+            memcpy(instance.texCoords, glyph.texCoords, sizeof(instance.texCoords));
 
-        Rect rect;
-        rect.topLeft = Vector3(quad.x0, quad.y0, topLeft.z);
-        rect.size = Vector2(quad.x1 - quad.x0, quad.y1 - quad.y0);
+            instance.color = packedColor;
+            instance.texIndex = textureSlot;
+            instance.flags = QUAD_SDF;
+            instance.padding[0] = instance.padding[1] = 0;
 
-        Vector4 texCoords(quad.s0, quad.t0, quad.s1, quad.t1);
+            WriteInstance(&instances[i], instance);
+        }
 
-        AddTexturedQuad(app, rect, texCoords, font.bitmapTexID, color);
+        uiData.frameQuadCount += count;
+        uiData.batchQuadCount += count;
     }
 }
 
@@ -456,8 +1250,9 @@ bool RenderButton(Application& app, ID id, const Rect& rect, Vector4 defaultColo
     bool result = false;
 
     Vector4 color = defaultColor;
-    if (app.mouseX >= rect.topLeft.x && app.mouseX <= rect.topLeft.x + rect.size.x &&
-        app.mouseY >= rect.topLeft.y && app.mouseY <= rect.topLeft.y + rect.size.y)
+    Vector2 mouse = MousePosition(app);
+    if (mouse.x >= rect.topLeft.x && mouse.x <= rect.topLeft.x + rect.size.x &&
+        mouse.y >= rect.topLeft.y && mouse.y <= rect.topLeft.y + rect.size.y)
     {
         if (uiData.hot != id)
             uiData.hot = id;
@@ -492,28 +1287,21 @@ bool RenderButton(Application& app, ID id, const Rect& rect, Vector4 defaultColo
 
 void RenderImage(Application& app, Image& image, Vector3 topLeft, Vector4 tint)
 {
-    // Only draw the part of the rect that is inside the screen
-
     Rect rect;
-    rect.topLeft.x = std::max(0.0f, topLeft.x);
-    rect.topLeft.y = std::max(0.0f, topLeft.y);
-    rect.topLeft.z = topLeft.z;
-
-    f32 amountCoveredX = rect.topLeft.x - topLeft.x;
-    f32 amountCoveredY = rect.topLeft.y - topLeft.y;
+    rect.topLeft = topLeft;
+    rect.size = Vector2((f32) image.scaledWidth, (f32) image.scaledHeight);
 
-    rect.size.x = std::min(app.refScreenWidth - rect.topLeft.x,  (f32) image.scaledWidth - amountCoveredX);
-    rect.size.y = std::min(app.refScreenHeight - rect.topLeft.y, (f32) image.scaledHeight - amountCoveredY);
-
-    f32 s1 = amountCoveredX / image.scaledWidth;
-    f32 t1 = 1.0f - amountCoveredY / image.scaledHeight;
-    f32 s2 = (rect.size.x + amountCoveredX) / image.scaledWidth;
-    f32 t2 = 1.0f - (rect.size.y + amountCoveredY) / image.scaledHeight;
-
-    Vector4 texCoords(s1, t1, s2, t2);
+    // Images are loaded flipped for OpenGL
+    Vector4 texCoords(0.0f, 1.0f, 1.0f, 0.0f);
     AddTexturedQuad(app, rect, texCoords, image.texID, tint);
 }
 
+void RenderCheckerboard(Application& app, const Rect& rect, Vector4 color)
+{
+    Vector4 texCoords { 0.0f, 1.0f, 1.0f, 0.0f };
+    AddTexturedQuad(app, rect, texCoords, uiData.whiteTextureID, color, QUAD_CHECKER);
+}
+
 void RenderTextBox(Application& app, const std::string_view& text, const Font& font,
                    Vector4 fontColor, Vector4 bgColor,
                    Vector2 padding, Vector3 topLeft)
@@ -585,8 +1373,9 @@ void RenderTextInput(Application& app, ID id, std::string& text, const Font& fon
 
     static Vector4 textColor = Vector4(1.0f);
 
-    if (app.mouseX >= containerRect.topLeft.x && app.mouseX <= containerRect.topLeft.x + containerRect.size.x &&
-        app.mouseY >= containerRect.topLeft.y && app.mouseY <= containerRect.topLeft.y + containerRect.size.y)
+    Vector2 mouse = MousePosition(app);
+    if (mouse.x >= containerRect.topLeft.x && mouse.x <= containerRect.topLeft.x + containerRect.size.x &&
+        mouse.y >= containerRect.topLeft.y && mouse.y <= containerRect.topLeft.y + containerRect.size.y)
     {
         if (uiData.hot != id)
             uiData.hot = id;
@@ -741,7 +1530,7 @@ void RenderTextInput(Application& app, ID id, std::string& text, const Font& fon
         // Place cursor at mouse
         if (app.GetMouseButtonDown(MOUSE(1)))
         {
-            f32 mouseXOffset = app.mouseX - topLeft.x - padding.x;
+            f32 mouseXOffset = mouse.x - topLeft.x - padding.x;
             selection[0] = selection[1] = std::max(std::min((s32) ((mouseXOffset / avgLetterWidth) + 0.3f), numLettersToShow), 0);
         }
 
@@ -760,6 +1549,9 @@ void RenderTextInput(Application& app, ID id, std::string& text, const Font& fon
 
             f32 caretAlpha = 0.5 * (sin(10.0 * (app.time - lastMoveTime)) + 1.0);
             RenderRect(app, caret, { 0.0f, 0.0f, 0.0f, caretAlpha });
+
+            // Keep the caret fading while the box has focus
+            app.RequestRedrawAt(app.time + caretFrameTime);
         }
         else
         {
@@ -801,8 +1593,9 @@ void RenderNumericInputf(Application& app, ID id, f32& num, std::string& text, c
         text = buffer;
     }
 
-    if (app.mouseX >= containerRect.topLeft.x && app.mouseX <= containerRect.topLeft.x + containerRect.size.x &&
-        app.mouseY >= containerRect.topLeft.y && app.mouseY <= containerRect.topLeft.y + containerRect.size.y)
+    Vector2 mouse = MousePosition(app);
+    if (mouse.x >= containerRect.topLeft.x && mouse.x <= containerRect.topLeft.x + containerRect.size.x &&
+        mouse.y >= containerRect.topLeft.y && mouse.y <= containerRect.topLeft.y + containerRect.size.y)
     {
         if (uiData.hot != id)
             uiData.hot = id;
@@ -957,7 +1750,7 @@ void RenderNumericInputf(Application& app, ID id, f32& num, std::string& text, c
         // Place cursor at mouse
         if (app.GetMouseButtonDown(MOUSE(1)))
         {
-            f32 mouseXOffset = app.mouseX - topLeft.x - padding.x;
+            f32 mouseXOffset = mouse.x - topLeft.x - padding.x;
             selection[0] = selection[1] = std::max(std::min((s32) ((mouseXOffset / avgLetterWidth) + 0.3f), numLettersToShow), 0);
         }
 
@@ -976,6 +1769,9 @@ void RenderNumericInputf(Application& app, ID id, f32& num, std::string& text, c
 
             f32 caretAlpha = 0.5 * (sin(10.0 * (app.time - lastMoveTime)) + 1.0);
             RenderRect(app, caret, { 0.0f, 0.0f, 0.0f, caretAlpha });
+
+            // Keep the caret fading while the box has focus
+            app.RequestRedrawAt(app.time + caretFrameTime);
         }
         else
         {
@@ -1021,8 +1817,9 @@ void RenderNumericInputi(Application& app, ID id, s32& num, std::string& text, c
         text = buffer;
     }
 
-    if (app.mouseX >= containerRect.topLeft.x && app.mouseX <= containerRect.topLeft.x + containerRect.size.x &&
-        app.mouseY >= containerRect.topLeft.y && app.mouseY <= containerRect.topLeft.y + containerRect.size.y)
+    Vector2 mouse = MousePosition(app);
+    if (mouse.x >= containerRect.topLeft.x && mouse.x <= containerRect.topLeft.x + containerRect.size.x &&
+        mouse.y >= containerRect.topLeft.y && mouse.y <= containerRect.topLeft.y + containerRect.size.y)
     {
         if (uiData.hot != id)
             uiData.hot = id;
@@ -1177,7 +1974,7 @@ void RenderNumericInputi(Application& app, ID id, s32& num, std::string& text, c
         // Place cursor at mouse
         if (app.GetMouseButtonDown(MOUSE(1)))
         {
-            f32 mouseXOffset = app.mouseX - topLeft.x - padding.x;
+            f32 mouseXOffset = mouse.x - topLeft.x - padding.x;
             selection[0] = selection[1] = std::max(std::min((s32) ((mouseXOffset / avgLetterWidth) + 0.3f), numLettersToShow), 0);
         }
 
@@ -1196,6 +1993,9 @@ void RenderNumericInputi(Application& app, ID id, s32& num, std::string& text, c
 
             f32 caretAlpha = 0.5 * (sin(10.0 * (app.time - lastMoveTime)) + 1.0);
             RenderRect(app, caret, { 0.0f, 0.0f, 0.0f, caretAlpha });
+
+            // Keep the caret fading while the box has focus
+            app.RequestRedrawAt(app.time + caretFrameTime);
         }
         else
         {
@@ -1,7 +1,6 @@
 #pragma once
 
 #include <string_view>
-#include <stb/stb_truetype.h>
 #include "platform/application.h"
 #include "math/types.h"
 
@@ -9,10 +8,34 @@ namespace UI
 {
 
 void Init();
-void Begin();
+void Begin(const Application& app);
 void End();
 void Shutdown();
 
+// Everything added after this call is drawn through the view matrix, hit tests
+// map the mouse back with its inverse. Changing the view flushes the current batch.
+void SetViewMatrix(const Matrix3x2& view);
+const Matrix3x2& GetViewMatrix();
+
+struct BatchStats
+{
+    u32 drawCalls;
+    u32 quadCount;
+    u64 bytesUploaded;      // Instance data the GPU read from a freshly written region
+    bool reusedUpload;      // Frame matched the last one and was drawn from the region that already held it
+
+    // Why batches were split
+    u32 bufferFlushes;      // Vertex buffer was full
+    u32 textureFlushes;     // Every texture slot was taken
+    u32 viewFlushes;        // View matrix changed
+};
+
+// Counts for the last full frame, between the previous Begin and End
+const BatchStats& GetLastFrameStats();
+
+// Texture units the batcher spreads quads over, the lower of GL_MAX_TEXTURE_IMAGE_UNITS and 32
+s32 GetTextureSlotCount();
+
 struct ID
 {
     s32 primary;
@@ -28,15 +51,20 @@ struct Rect
     Vector2 size;
 };
 
+struct FontAtlas;
+
+// Glyphs are stored as distance fields in a single channel atlas so text stays sharp at any scale.
+// Printable ASCII is baked on load, other codepoints the first time they're drawn.
 struct Font
 {
     u32 bitmapTexID;
     u32 bitmapWidth, bitmapHeight;
     f32 fontHeight;
 
-    stbtt_bakedchar charData[128 - ' '];
+    FontAtlas* atlas = nullptr;
 
-    void Load(const std::string_view& filepath, f32 height);
+    // Returns false if the file isn't a font stb_truetype can read, text drawn with it is skipped
+    bool Load(const std::string_view& filepath, f32 height);
     void Free();
 };
 
@@ -45,6 +73,7 @@ struct Image
     u32 texID;
     s32 width, height;
     s32 scaledWidth, scaledHeight;
+    s32 channels = 0;       // 3 for RGB, 4 for RGBA
     u8* pixels= nullptr;
 
     void SetScale(const Vector2& scale);
@@ -65,6 +94,10 @@ bool RenderButton(Application& app, ID id, const Rect& rect, Vector4 defaultColo
 
 void RenderImage(Application& app, Image& image, Vector3 topLeft, Vector4 tint = Vector4(1.0f));
 
+// Cells are one unit of the current view, alternating between color and color at half brightness.
+// Fades to the average when cells get smaller than a pixel.
+void RenderCheckerboard(Application& app, const Rect& rect, Vector4 color);
+
 void RenderTextBox(Application& app, const std::string_view& text, const Font& font,
                    Vector4 fontColor, Vector4 rectColor,
                    Vector2 padding, Vector3 topLeft);
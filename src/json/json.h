@@ -2,14 +2,14 @@
 
 #include <string>
 #include "containers/darray.h"
-#include "containers/hash_table.h"
+#include "containers/ordered_table.h"
 
 namespace json
 {
 
 using String = std::string;
 using ArrayNode  = gn::darray<size_t>;
-using ObjectNode = gn::hash_table<std::string, size_t, std::hash<std::string>>;
+using ObjectNode = gn::ordered_table<std::string, size_t>;
 
 struct Resource
 {
@@ -99,7 +99,7 @@ struct DependencyNode
 
             case Type::OBJECT:
             {
-                _object.~hash_table();
+                _object.~ordered_table();
             } break;
         }
     }
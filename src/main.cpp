@@ -8,6 +8,7 @@
 
 #include "containers/darray.h"
 #include "engine/ui.h"
+#include "math/batch.h"
 #include "platform/application.h"
 #include "program/animation.h"
 #include "program/background.h"
@@ -19,22 +20,33 @@
 
 UI::Font font;
 
-BackgroundTexture bg;
+Background bg;
 
-Vector3 imagePosition, imageStartPos;
-f32 scale = 3.0f;
+// Image pixels to reference screen pixels, pan and zoom only touch this
+Matrix3x2 canvasView;
+constexpr f32 defaultScale = 3.0f;
 
 bool isDragging = false;
-UI::Rect drawingRect;
+IRect drawingRect;     // Image pixels, y going down from the top row
+
+gn::darray<Vector4> frameDisplayRects;
 
 f32 maxNameWidth, maxAllowedNameLength = 15;
 
 Context context;
 
-inline bool MouseInRect(Application& app, f32 x, f32 y, f32 w, f32 h)
+inline Vector2 MouseInImage(Application& app)
+{
+    return Inverse(canvasView) * Vector2((f32) app.mouseX, (f32) app.mouseY);
+}
+
+// Centers an image of the given size on the screen at the default scale
+inline Matrix3x2 CenteredCanvasView(Application& app, f32 width, f32 height)
 {
-    return app.mouseX >= x && app.mouseX <= x + w &&
-           app.mouseY >= y && app.mouseY <= y + h;
+    Vector2 offset((app.refScreenWidth  - width  * defaultScale) / 2.0f,
+                   (app.refScreenHeight - height * defaultScale) / 2.0f);
+
+    return Matrix3x2::Translation(offset) * Matrix3x2::Scaling(defaultScale);
 }
 
 void OpenFile(Application& app, const std::string& newpath)
@@ -67,18 +79,19 @@ void OpenFile(Application& app, const std::string& newpath)
 
     if (!context.imageLoadError)
     {
-        context.selectedFrameIndex = context.selectedAnimationIndex = -1;
+        context.selectedFrame = context.selectedAnimation = gn::slot_handle();
 
-        bg.Free();
+        context.opaquePixels = gn::bitmap2d(context.image.width, context.image.height);
 
-        scale = 3.0f;
-        context.image.SetScale(scale);
+        // Without an alpha channel every pixel is opaque
+        if (context.image.channels == 4)
+            context.opaquePixels.set_from_bytes(context.image.pixels, 4, 3);
+        else
+            context.opaquePixels.set_all();
 
         bg.Create(context.image.width, context.image.height);
-        bg.SetScale(scale);
 
-        imagePosition.x = (app.refScreenWidth -  context.image.scaledWidth)  / 2.0f;
-        imagePosition.y = (app.refScreenHeight - context.image.scaledHeight) / 2.0f;
+        canvasView = CenteredCanvasView(app, context.image.width, context.image.height);
 
         size_t start = context.fullpath.find_last_of('\\');
         context.filename = context.fullpath.substr(start + 1);
@@ -117,11 +130,8 @@ int main()
         font.Load("res/fonts/Lato-Regular.ttf", 25.0f);
 
         bg.CreateDefault();
-        bg.SetScale(scale);
 
-        imagePosition.x = (app.refScreenWidth -  bg.image.scaledWidth)  / 2.0f;
-        imagePosition.y = (app.refScreenHeight - bg.image.scaledHeight) / 2.0f;
-        imagePosition.z = 0.1f;
+        canvasView = CenteredCanvasView(app, bg.width, bg.height);
 
         maxNameWidth = UI::GetRenderedTextSize("Loop:\tPing Pong", font).x + 10.0f;
     };
@@ -138,6 +148,7 @@ int main()
 
         {   // Dragging Canvas Controls
             static Vector2 mouseStartPos;
+            static Matrix3x2 viewStart;
 
             if (app.GetMouseButtonDown(MOUSE(3)) ||
                 (app.GetKey(KEY(SPACE)) && app.GetMouseButtonDown(MOUSE(1))))
@@ -145,44 +156,49 @@ int main()
                 mouseStartPos.x = app.mouseX;
                 mouseStartPos.y = app.mouseY;
 
-                imageStartPos = imagePosition;
+                viewStart = canvasView;
             } else if (app.GetMouseButton(MOUSE(3)) ||
                        (app.GetKey(KEY(SPACE)) && app.GetMouseButton(MOUSE(1))))
             {
-                imagePosition.x = (app.mouseX - mouseStartPos.x) + imageStartPos.x;
-                imagePosition.y = (app.mouseY - mouseStartPos.y) + imageStartPos.y;
+                Vector2 displacement((f32) app.mouseX - mouseStartPos.x, (f32) app.mouseY - mouseStartPos.y);
+                canvasView = Matrix3x2::Translation(displacement) * viewStart;
             }
         }
 
-        if (context.selectedAnimationIndex > -1)
+        if (context.AnimationSelected())
         {   // Dragging Frame Rect
-            static Vector2 mouseStartPos;
+            static Vector2 mouseStartPos;   // Image pixels
 
             if (app.GetKey(KEY(LEFT_CONTROL)) && app.GetMouseButtonDown(MOUSE(1)))
             {
-                if (MouseInRect(app, imagePosition.x, imagePosition.y, bg.image.scaledWidth, bg.image.scaledHeight))
+                Vector2 mouse = MouseInImage(app);
+
+                if (mouse.x >= 0.0f && mouse.x <= bg.width &&
+                    mouse.y >= 0.0f && mouse.y <= bg.height)
                 {
-                    mouseStartPos.x = std::max((f32) app.mouseX, imagePosition.x);
-                    mouseStartPos.y = std::max((f32) app.mouseY, imagePosition.y);
+                    mouseStartPos = mouse;
                     isDragging = true;
-                    context.selectedFrameIndex = -1;
+                    drawingRect = IRect();
+                    context.selectedFrame = gn::slot_handle();
                 }
             } else if (isDragging && app.GetMouseButton(MOUSE(1)))
             {
-                f32 x = std::max(std::min(mouseStartPos.x, (f32) app.mouseX), imagePosition.x);
-                f32 y = std::max(std::min(mouseStartPos.y, (f32) app.mouseY), imagePosition.y);
+                // Every pixel touched between the two mouse positions
+                Vector2 mouse = MouseInImage(app);
 
-                drawingRect.topLeft.x = floorf((x - imagePosition.x) / scale);
-                drawingRect.topLeft.y = floorf((y - imagePosition.y) / scale);
+                f32 startX = mouseStartPos.x;
+                f32 startY = mouseStartPos.y;
+                f32 endX   = mouse.x;
+                f32 endY   = mouse.y;
 
-                f32 mouseOffsetX = drawingRect.topLeft.x - imagePosition.x;
-                f32 mouseOffsetY = drawingRect.topLeft.y - imagePosition.y;
+                IRect dragged = IRectFromCorners((s32) floorf(std::min(startX, endX)), (s32) floorf(std::min(startY, endY)),
+                                                 (s32) ceilf(std::max(startX, endX)),  (s32) ceilf(std::max(startY, endY)));
 
-                f32 w = std::min(std::abs((f32) app.mouseX - mouseStartPos.x), bg.image.scaledWidth - mouseOffsetX);
-                f32 h = std::min(std::abs((f32) app.mouseY - mouseStartPos.y), bg.image.scaledHeight - mouseOffsetY);
+                // A click without moving doesn't make a frame
+                if (startX == endX && startY == endY)
+                    dragged = IRect();
 
-                drawingRect.size.x = roundf(w / scale + 0.35f);
-                drawingRect.size.y = roundf(h / scale + 0.35f);
+                drawingRect = ClipToImage(dragged, context.image.width, context.image.height);
             }
 
             if (isDragging && app.GetMouseButtonDown(MOUSE(2)))
@@ -190,18 +206,16 @@ int main()
 
             if (isDragging && app.GetMouseButtonUp(MOUSE(1)))
             {
-                if (drawingRect.size.x > 0.0f && drawingRect.size.y > 0.0f)
+                if (!drawingRect.Empty())
                 {
-                    context.selectedFrameIndex = context.CurrentAnimation().frames.size();
-                    
-                    AnimationFrame& frame = context.CurrentAnimation().frames.emplace_back();
-                    frame.topLeft.x = drawingRect.topLeft.x;
-                    frame.topLeft.y = context.image.height - drawingRect.topLeft.y;
+                    auto& frames = context.CurrentAnimation().frames;
+                    context.selectedFrame = frames.emplace();
 
-                    frame.size.x = drawingRect.size.x;
-                    frame.size.y = drawingRect.size.y;
+                    auto [rect, pivot] = frames[context.selectedFrame];
+                    rect = drawingRect;
+                    rect.y = context.image.height - drawingRect.MaxY();
 
-                    frame.pivot.x = frame.pivot.y = 0.5f;
+                    pivot.x = pivot.y = 0.5f;
                 }
 
                 isDragging = false;
@@ -211,45 +225,61 @@ int main()
 
     app.onRender = [](Application& app)
     {
-        UI::Begin();
+        UI::Begin(app);
+
+        {   // Render Image, everything in here is in image pixels
+            UI::SetViewMatrix(canvasView);
 
-        {   // Render Image
-            UI::RenderImage(app, bg.image, imagePosition);
+            const Vector3 imageTopLeft(0.0f, 0.0f, 0.1f);
+            bg.Render(app, imageTopLeft);
 
             if (context.imageLoaded)
             {
-                UI::RenderImage(app, context.image, imagePosition);
+                UI::RenderImage(app, context.image, imageTopLeft);
 
-                if (context.selectedAnimationIndex > -1)
+                if (context.AnimationSelected())
                 {
-                    for (int i = 0; i < context.CurrentAnimation().frames.size(); i++)
+                    auto& frames = context.CurrentAnimation().frames;
+
+                    // Frames are stored with y going up from the bottom of the image
+                    Transform2D frameToImage = FlipY2D((f32) context.image.height);
+
+                    // darray::resize(0) would realloc to 0 bytes, an empty animation has nothing to map anyway
+                    if (frames.size() > 0)
                     {
-                        AnimationFrame& frame = context.CurrentAnimation().frames[i];
+                        if (frameDisplayRects.size() != frames.size())
+                            frameDisplayRects.resize(frames.size());
+
+                        TransformIRects(frameToImage, frames.dense().field<FRAME_RECT>(), sizeof(IRect), frameDisplayRects.data(), frames.size());
+                    }
+
+                    for (int i = 0; i < frames.size(); i++)
+                    {
+                        gn::slot_handle handle = frames.handle_at(i);
+                        const Vector4& imageRect = frameDisplayRects[i];
                         UI::Rect displayRect;
                     
-                        displayRect.topLeft.x = scale * frame.topLeft.x + imagePosition.x;
-                        displayRect.topLeft.y = scale * (context.image.height - frame.topLeft.y) + imagePosition.y;
-                    
-                        displayRect.size = scale * frame.size;
+                        displayRect.topLeft.x = imageRect.x;
+                        displayRect.topLeft.y = imageRect.y;
+                        displayRect.size = Vector2(imageRect.z, imageRect.w);
 
-                        const Vector4& color = (i == context.selectedFrameIndex) ? orange : green;
+                        const Vector4& color = (handle == context.selectedFrame) ? orange : green;
                         if (UI::RenderButton(app, GenUIIDWithSec(i), displayRect, color, lgreen, orange))
-                            context.selectedFrameIndex = (i == context.selectedFrameIndex) ? -1 : i;
+                            context.selectedFrame = (handle == context.selectedFrame) ? gn::slot_handle() : handle;
                     }
 
                     if (isDragging)
                     {   //  Render current frame
                         UI::Rect displayRect;
-                    
-                        displayRect.topLeft.x = scale * drawingRect.topLeft.x + imagePosition.x;
-                        displayRect.topLeft.y = scale * drawingRect.topLeft.y + imagePosition.y;
-                    
-                        displayRect.size = scale * drawingRect.size;
+                        displayRect.topLeft = Vector3((f32) drawingRect.x, (f32) drawingRect.y, 0.0f);
+                        displayRect.size = Vector2((f32) drawingRect.width, (f32) drawingRect.height);
 
                         UI::RenderRect(app, displayRect, red);
                     }
                 }
             }
+
+            UI::SetViewMatrix(Matrix3x2());
         }
 
         {   // Meta data and Open and Save Options
@@ -295,12 +325,13 @@ int main()
                 for (int i = 0; i < context.animations.size(); i++)
                 {
                     std::string_view name = context.animations[i].name;
+                    gn::slot_handle handle = context.animations.handle_at(i);
 
                     Vector2 size = UI::GetRenderedTextSize(name, font);
                     Vector3 topLeft(app.refScreenWidth - maxNameWidth - 10.0f - hgap, height, 0.0f);
 
                     // Render a marker for selected animation
-                    if (i == context.selectedAnimationIndex)
+                    if (handle == context.selectedAnimation)
                     {
                         static std::string_view marker = "> ";
                         static f32 offset = UI::GetRenderedTextSize(marker, font).x;
@@ -319,22 +350,22 @@ int main()
 
                     if (UI::RenderTextButton(app, GenUIIDWithSec(i), concatenatedName, font, Vector2(10.0f, 5.0f), topLeft))
                     {
-                        if (i == context.selectedAnimationIndex)
-                            context.selectedAnimationIndex = -1;
+                        if (handle == context.selectedAnimation)
+                            context.selectedAnimation = gn::slot_handle();
                         else
-                            context.selectedAnimationIndex = i;
+                            context.selectedAnimation = handle;
 
-                        context.selectedFrameIndex = -1;
+                        context.selectedFrame = gn::slot_handle();
                     }
 
                     height += size.y + vgap;
 
-                    if (i == context.selectedAnimationIndex)
+                    if (handle == context.selectedAnimation)
                     {
                         Vector2 size = RenderAnimationInfo(app, font, context, Vector3(topLeft.x + hgap / 2.0f, height, 0.0f));
 
                         // If animation gets deleted, then walk back one step
-                        if (context.selectedAnimationIndex == -1)
+                        if (!context.AnimationSelected())
                             i--;
 
                         height += size.y + vgap;
@@ -344,14 +375,14 @@ int main()
                 }
             }
 
-            if (context.selectedFrameIndex != -1)
+            if (context.FrameSelected())
             {   // List Animation Frame Data
                 RenderFrameInfo(app, font, context);
             }
 
             if (RenderNewAnimationDialog(app, font, context))
             {
-                std::string_view name = context.animations[context.animations.size() - 1].name;
+                std::string_view name = context.animations.back().name;
                 
                 if (name.length() > maxAllowedNameLength)
                 {
@@ -364,8 +395,8 @@ int main()
                     maxNameWidth = std::max(size.x, maxNameWidth);
                 }
 
-                context.selectedAnimationIndex = context.animations.size() - 1;
-                context.selectedFrameIndex = -1;
+                context.selectedAnimation = context.animations.handle_at(context.animations.size() - 1);
+                context.selectedFrame = gn::slot_handle();
             }
         }
 
@@ -383,7 +414,11 @@ int main()
             }
 
             static char buffer[256];
-            sprintf(buffer, "Frame Time: %fms, Frame Rate: %.0f", frameTime, 1.0 / frameTime);
+            const UI::BatchStats& stats = UI::GetLastFrameStats();
+            sprintf(buffer, "Frame Time: %fms, Frame Rate: %.0f, Draw Calls: %u (%u quads, %.1f KB%s), Flushes: %u buffer %u texture %u view",
+                    frameTime, 1.0 / frameTime, stats.drawCalls, stats.quadCount, stats.bytesUploaded / 1024.0,
+                    stats.reusedUpload ? ", reused" : "",
+                    stats.bufferFlushes, stats.textureFlushes, stats.viewFlushes);
 
             Vector3 topLeft(0.0f, app.refScreenHeight - 0.8f * font.fontHeight, 0.0f);
             UI::RenderTextBox(app, buffer, font, white, grey, Vector2(), topLeft);
@@ -410,20 +445,15 @@ int main()
             
         constexpr f32 scrollSpeed = 1.0f;
 
-        f32 relativePosX = (app.mouseX - imagePosition.x) / bg.image.scaledWidth;
-        f32 relativePosY = (app.mouseY - imagePosition.y) / bg.image.scaledHeight;
-
-        imagePosition.x = imagePosition.x + (bg.image.scaledWidth * relativePosX);
-        imagePosition.y = imagePosition.y + (bg.image.scaledHeight * relativePosY);
-
-        scale += scrollY * scrollSpeed * (0.15f * scale);
-        scale = Clamp(scale, 0.5f, 50.0f);
-
-        context.image.SetScale(scale);
-        bg.SetScale(scale);
+        // The view only pans and zooms, so its x axis length is the scale
+        f32 scale = canvasView.data[0];
+        f32 newScale = scale + scrollY * scrollSpeed * (0.15f * scale);
+        newScale = Clamp(newScale, 0.5f, 50.0f);
 
-        imagePosition.x = imagePosition.x - (bg.image.scaledWidth * relativePosX);
-        imagePosition.y = imagePosition.y - (bg.image.scaledHeight * relativePosY);
+        // Zoom about the mouse so the pixel under it stays put
+        Vector2 mouse((f32) app.mouseX, (f32) app.mouseY);
+        canvasView = Matrix3x2::Translation(mouse) * Matrix3x2::Scaling(newScale / scale) *
+                     Matrix3x2::Translation(Vector2(-mouse.x, -mouse.y)) * canvasView;
     };
 
     app.dropCallback = [](Application& app, s32 count, const char** paths)
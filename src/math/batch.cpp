@@ -0,0 +1,369 @@
+#include "batch.h"
+
+#include <cmath>
+#include <xmmintrin.h>
+#include <immintrin.h>
+#include "basic_types.h"
+#include "cpu.h"
+
+Transform2D Compose(const Transform2D& first, const Transform2D& second)
+{
+    Transform2D result;
+    result.scale  = Vector2(first.scale.x * second.scale.x, first.scale.y * second.scale.y);
+    result.offset = second.Apply(first.offset);
+    return result;
+}
+
+Transform2D Scale2D(const Vector2& scale)
+{
+    Transform2D result;
+    result.scale = scale;
+    return result;
+}
+
+Transform2D Translate2D(const Vector2& offset)
+{
+    Transform2D result;
+    result.offset = offset;
+    return result;
+}
+
+Transform2D FlipY2D(f32 height)
+{
+    Transform2D result;
+    result.scale  = Vector2(1.0f, -1.0f);
+    result.offset = Vector2(0.0f, height);
+    return result;
+}
+
+Transform2D ToNDC2D(f32 width, f32 height)
+{
+    Transform2D result;
+    result.scale  = Vector2(2.0f / width, -2.0f / height);
+    result.offset = Vector2(-1.0f, 1.0f);
+    return result;
+}
+
+// Scalar
+
+void TransformVectorsScalar(const Matrix4& transform, const Vector4* in, Vector4* out, size_t count)
+{
+    const auto& m = transform.data;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector4 v = in[i];
+        for (int row = 0; row < 4; row++)
+            out[i].data[row] = m[0][row] * v.x + m[1][row] * v.y + m[2][row] * v.z + m[3][row] * v.w;
+    }
+}
+
+void NormalizeVectorsScalar(const Vector4* in, Vector4* out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector4 v = in[i];
+        f32 length = sqrtf(v.x * v.x + v.y * v.y + v.z * v.z + v.w * v.w);
+
+        if (length == 0.0f)
+            out[i] = v;
+        else
+            out[i] = Vector4(v.x / length, v.y / length, v.z / length, v.w / length);
+    }
+}
+
+void LerpVectorsScalar(const Vector4* a, const Vector4* b, f32 t, Vector4* out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        for (int j = 0; j < 4; j++)
+            out[i].data[j] = a[i].data[j] * (1.0f - t) + b[i].data[j] * t;
+    }
+}
+
+// SSE, two points or one rect per register
+
+static void TransformPointsMatrixSSE(const Matrix3x2& transform, const Vector2* in, Vector2* out, size_t count)
+{
+    // (x0, y0, x1, y1) -> xAxis * (x0, x0, x1, x1) + yAxis * (y0, y0, y1, y1) + translation
+    const __m128 xAxis = _mm_movelh_ps(transform.sseData[0], transform.sseData[0]);
+    const __m128 yAxis = _mm_movehl_ps(transform.sseData[0], transform.sseData[0]);
+    const __m128 translation = _mm_movelh_ps(transform.sseData[1], transform.sseData[1]);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128 points = _mm_loadu_ps(&in[i].x);
+        __m128 xs = _mm_shuffle_ps(points, points, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 ys = _mm_shuffle_ps(points, points, _MM_SHUFFLE(3, 3, 1, 1));
+
+        __m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(xAxis, xs), _mm_mul_ps(yAxis, ys)), translation);
+        _mm_storeu_ps(&out[i].x, result);
+    }
+
+    for (; i < count; i++)
+        out[i] = transform * in[i];
+}
+
+static void TransformIRectsSSE(const Transform2D& transform, const IRect* in, size_t stride, Vector4* out, size_t count)
+{
+    const __m128 scale  = _mm_setr_ps(transform.scale.x, transform.scale.y, transform.scale.x, transform.scale.y);
+    const __m128 offset = _mm_setr_ps(transform.offset.x, transform.offset.y, transform.offset.x, transform.offset.y);
+
+    const u8* src = (const u8*) in;
+    for (size_t i = 0; i < count; i++, src += stride)
+    {
+        // (x, y, width, height) -> (x, y, maxX, maxY)
+        __m128i rect = _mm_loadu_si128((const __m128i*) src);
+        __m128 corners = _mm_cvtepi32_ps(_mm_add_epi32(rect, _mm_slli_si128(rect, 8)));
+        corners = _mm_add_ps(_mm_mul_ps(corners, scale), offset);
+
+        __m128 swapped = _mm_shuffle_ps(corners, corners, _MM_SHUFFLE(1, 0, 3, 2));
+        __m128 low  = _mm_min_ps(corners, swapped);
+        __m128 high = _mm_max_ps(corners, swapped);
+
+        _mm_storeu_ps(out[i].data, _mm_movelh_ps(low, _mm_sub_ps(high, low)));
+    }
+}
+
+void TransformVectorsSSE(const Matrix4& transform, const Vector4* in, Vector4* out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = transform * in[i];
+}
+
+void NormalizeVectorsSSE(const Vector4* in, Vector4* out, size_t count)
+{
+    const __m128 zero = _mm_setzero_ps();
+
+    for (size_t i = 0; i < count; i++)
+    {
+        __m128 v = in[i].sseData;
+
+        // Dot product in every lane
+        __m128 sqr = _mm_mul_ps(v, v);
+        sqr = _mm_add_ps(sqr, _mm_shuffle_ps(sqr, sqr, _MM_SHUFFLE(2, 3, 0, 1)));
+        sqr = _mm_add_ps(sqr, _mm_shuffle_ps(sqr, sqr, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        __m128 length = _mm_sqrt_ps(sqr);
+        __m128 isZero = _mm_cmpeq_ps(length, zero);
+        __m128 unit = _mm_div_ps(v, length);
+
+        out[i].sseData = _mm_or_ps(_mm_and_ps(isZero, v), _mm_andnot_ps(isZero, unit));
+    }
+}
+
+void LerpVectorsSSE(const Vector4* a, const Vector4* b, f32 t, Vector4* out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = Lerp(a[i], b[i], t);
+}
+
+// AVX2 + FMA, four points, two rects or two vectors per register
+
+GN_TARGET_AVX2_FMA
+static void TransformPointsMatrixAVX2(const Matrix3x2& transform, const Vector2* in, Vector2* out, size_t count)
+{
+    const __m128 xAxis4 = _mm_movelh_ps(transform.sseData[0], transform.sseData[0]);
+    const __m128 yAxis4 = _mm_movehl_ps(transform.sseData[0], transform.sseData[0]);
+    const __m128 translation4 = _mm_movelh_ps(transform.sseData[1], transform.sseData[1]);
+
+    const __m256 xAxis = _mm256_set_m128(xAxis4, xAxis4);
+    const __m256 yAxis = _mm256_set_m128(yAxis4, yAxis4);
+    const __m256 translation = _mm256_set_m128(translation4, translation4);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256 points = _mm256_loadu_ps(&in[i].x);
+        __m256 xs = _mm256_shuffle_ps(points, points, _MM_SHUFFLE(2, 2, 0, 0));
+        __m256 ys = _mm256_shuffle_ps(points, points, _MM_SHUFFLE(3, 3, 1, 1));
+
+        _mm256_storeu_ps(&out[i].x, _mm256_fmadd_ps(xAxis, xs, _mm256_fmadd_ps(yAxis, ys, translation)));
+    }
+
+    for (; i < count; i++)
+        out[i] = transform * in[i];
+}
+
+GN_TARGET_AVX2_FMA
+static void TransformIRectsAVX2(const Transform2D& transform, const IRect* in, size_t stride, Vector4* out, size_t count)
+{
+    const __m128 scale4  = _mm_setr_ps(transform.scale.x, transform.scale.y, transform.scale.x, transform.scale.y);
+    const __m128 offset4 = _mm_setr_ps(transform.offset.x, transform.offset.y, transform.offset.x, transform.offset.y);
+
+    const __m256 scale  = _mm256_set_m128(scale4, scale4);
+    const __m256 offset = _mm256_set_m128(offset4, offset4);
+
+    const u8* src = (const u8*) in;
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2, src += 2 * stride)
+    {
+        // Same steps as the SSE version, the shifts and shuffles stay within each 128 bit lane
+        __m256i rects = _mm256_loadu2_m128i((const __m128i*) (src + stride), (const __m128i*) src);
+        __m256 corners = _mm256_cvtepi32_ps(_mm256_add_epi32(rects, _mm256_slli_si256(rects, 8)));
+        corners = _mm256_fmadd_ps(corners, scale, offset);
+
+        __m256 swapped = _mm256_shuffle_ps(corners, corners, _MM_SHUFFLE(1, 0, 3, 2));
+        __m256 low  = _mm256_min_ps(corners, swapped);
+        __m256 high = _mm256_max_ps(corners, swapped);
+
+        __m256 size = _mm256_sub_ps(high, low);
+        _mm256_storeu_ps(out[i].data, _mm256_shuffle_ps(low, size, _MM_SHUFFLE(1, 0, 1, 0)));
+    }
+
+    if (i < count)
+        TransformIRectsSSE(transform, (const IRect*) src, stride, out + i, count - i);
+}
+
+GN_TARGET_AVX2_FMA
+void TransformVectorsAVX2(const Matrix4& transform, const Vector4* in, Vector4* out, size_t count)
+{
+    // Both lanes hold the same column, each lane transforms one vector
+    const __m256 c0 = _mm256_broadcast_ps(&transform.sseColumns[0]);
+    const __m256 c1 = _mm256_broadcast_ps(&transform.sseColumns[1]);
+    const __m256 c2 = _mm256_broadcast_ps(&transform.sseColumns[2]);
+    const __m256 c3 = _mm256_broadcast_ps(&transform.sseColumns[3]);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m256 v = _mm256_loadu_ps(in[i].data);
+
+        __m256 result = _mm256_mul_ps(c0, _mm256_permute_ps(v, 0x00));
+        result = _mm256_fmadd_ps(c1, _mm256_permute_ps(v, 0x55), result);
+        result = _mm256_fmadd_ps(c2, _mm256_permute_ps(v, 0xaa), result);
+        result = _mm256_fmadd_ps(c3, _mm256_permute_ps(v, 0xff), result);
+
+        _mm256_storeu_ps(out[i].data, result);
+    }
+
+    if (i < count)
+        out[i] = transform * in[i];
+}
+
+GN_TARGET_AVX2_FMA
+void NormalizeVectorsAVX2(const Vector4* in, Vector4* out, size_t count)
+{
+    const __m256 zero = _mm256_setzero_ps();
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m256 v = _mm256_loadu_ps(in[i].data);
+
+        __m256 length = _mm256_sqrt_ps(_mm256_dp_ps(v, v, 0xFF));
+        __m256 isZero = _mm256_cmp_ps(length, zero, _CMP_EQ_OQ);
+
+        _mm256_storeu_ps(out[i].data, _mm256_blendv_ps(_mm256_div_ps(v, length), v, isZero));
+    }
+
+    if (i < count)
+        NormalizeVectorsSSE(in + i, out + i, count - i);
+}
+
+GN_TARGET_AVX2_FMA
+void LerpVectorsAVX2(const Vector4* a, const Vector4* b, f32 t, Vector4* out, size_t count)
+{
+    // a + (b - a) * t would be one fma, but it doesn't land exactly on b at t = 1
+    const __m256 tb = _mm256_set1_ps(t);
+    const __m256 ta = _mm256_set1_ps(1.0f - t);
+
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2)
+    {
+        __m256 va = _mm256_loadu_ps(a[i].data);
+        __m256 vb = _mm256_loadu_ps(b[i].data);
+
+        _mm256_storeu_ps(out[i].data, _mm256_fmadd_ps(va, ta, _mm256_mul_ps(vb, tb)));
+    }
+
+    if (i < count)
+        out[i] = Lerp(a[i], b[i], t);
+}
+
+// Dispatch
+
+// SSE2 is part of x64, so the SSE versions are the baseline. The scalar ones are only a reference.
+using TransformPointsMatrixFn = void (*)(const Matrix3x2&, const Vector2*, Vector2*, size_t);
+using TransformIRectsFn  = void (*)(const Transform2D&, const IRect*, size_t, Vector4*, size_t);
+using TransformVectorsFn = void (*)(const Matrix4&, const Vector4*, Vector4*, size_t);
+using NormalizeVectorsFn = void (*)(const Vector4*, Vector4*, size_t);
+using LerpVectorsFn      = void (*)(const Vector4*, const Vector4*, f32, Vector4*, size_t);
+
+void TransformPoints(const Matrix3x2& transform, const Vector2* in, Vector2* out, size_t count)
+{
+    static const TransformPointsMatrixFn impl = []() -> TransformPointsMatrixFn
+    {
+        const CpuFeatures& cpu = GetCpuFeatures();
+        if (cpu.avx2 && cpu.fma)
+            return TransformPointsMatrixAVX2;
+
+        return TransformPointsMatrixSSE;
+    }();
+
+    impl(transform, in, out, count);
+}
+
+void TransformIRects(const Transform2D& transform, const IRect* in, size_t stride, Vector4* out, size_t count)
+{
+    static const TransformIRectsFn impl = []() -> TransformIRectsFn
+    {
+        const CpuFeatures& cpu = GetCpuFeatures();
+        if (cpu.avx2 && cpu.fma)
+            return TransformIRectsAVX2;
+
+        return TransformIRectsSSE;
+    }();
+
+    impl(transform, in, stride, out, count);
+}
+
+void TransformVectors(const Matrix4& transform, const Vector4* in, Vector4* out, size_t count)
+{
+    static const TransformVectorsFn impl = []() -> TransformVectorsFn
+    {
+        const CpuFeatures& cpu = GetCpuFeatures();
+        if (cpu.avx2 && cpu.fma)
+            return TransformVectorsAVX2;
+
+        return TransformVectorsSSE;
+    }();
+
+    impl(transform, in, out, count);
+}
+
+void MultiplyMatrices(const Matrix4& left, const Matrix4* right, Matrix4* out, size_t count)
+{
+    // Every column of the product is left * that column of right
+    TransformVectors(left, (const Vector4*) right, (Vector4*) out, 4 * count);
+}
+
+void NormalizeVectors(const Vector4* in, Vector4* out, size_t count)
+{
+    static const NormalizeVectorsFn impl = []() -> NormalizeVectorsFn
+    {
+        const CpuFeatures& cpu = GetCpuFeatures();
+        if (cpu.avx2 && cpu.fma)
+            return NormalizeVectorsAVX2;
+
+        return NormalizeVectorsSSE;
+    }();
+
+    impl(in, out, count);
+}
+
+void LerpVectors(const Vector4* a, const Vector4* b, f32 t, Vector4* out, size_t count)
+{
+    static const LerpVectorsFn impl = []() -> LerpVectorsFn
+    {
+        const CpuFeatures& cpu = GetCpuFeatures();
+        if (cpu.avx2 && cpu.fma)
+            return LerpVectorsAVX2;
+
+        return LerpVectorsSSE;
+    }();
+
+    impl(a, b, t, out, count);
+}
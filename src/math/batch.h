@@ -0,0 +1,66 @@
+#pragma once
+
+#include "basic_types.h"
+#include "irect.h"
+#include "mats/matrix3x2.h"
+#include "mats/matrix4.h"
+#include "vecs/vector2.h"
+#include "vecs/vector4.h"
+
+// Per axis scale followed by a translation, enough for every 2D mapping the editor
+// needs (zoom, pan, flipping y, pixels to NDC) and cheap to compose and batch.
+struct Transform2D
+{
+    Vector2 scale  = Vector2(1.0f);
+    Vector2 offset = Vector2(0.0f);
+
+    inline Vector2 Apply(const Vector2& point) const
+    {
+        return Vector2(point.x * scale.x + offset.x, point.y * scale.y + offset.y);
+    }
+};
+
+// Applies first, then second
+Transform2D Compose(const Transform2D& first, const Transform2D& second);
+
+Transform2D Scale2D(const Vector2& scale);
+Transform2D Translate2D(const Vector2& offset);
+Transform2D FlipY2D(f32 height);                // y -> height - y
+Transform2D ToNDC2D(f32 width, f32 height);     // Top left origin pixels -> [-1, 1] with y up
+
+// Batch kernels, dispatched on the CPU features found at runtime (AVX2 + FMA, otherwise SSE).
+
+// in and out may point to the same array
+void TransformPoints(const Matrix3x2& transform, const Vector2* in, Vector2* out, size_t count);
+
+// Maps integer pixel rects, both corners go through the transform so flips and negative
+// scales are handled, results are packed as (x, y, width, height) with a positive size.
+void TransformIRects(const Transform2D& transform, const IRect* in, size_t stride, Vector4* out, size_t count);
+
+// 4D kernels over arrays of Vector4 and Matrix4, same dispatch as above.
+// in and out may point to the same array for all of these.
+
+void TransformVectors(const Matrix4& transform, const Vector4* in, Vector4* out, size_t count);
+
+// out[i] = left * right[i]
+void MultiplyMatrices(const Matrix4& left, const Matrix4* right, Matrix4* out, size_t count);
+
+// Zero length vectors are left as they are, like Vector4::Normalize
+void NormalizeVectors(const Vector4* in, Vector4* out, size_t count);
+
+void LerpVectors(const Vector4* a, const Vector4* b, f32 t, Vector4* out, size_t count);
+
+// The paths behind the 4D kernels, so they can be checked against each other. The scalar
+// ones are the reference, the AVX2 ones need GetCpuFeatures().avx2 and fma.
+
+void TransformVectorsScalar(const Matrix4& transform, const Vector4* in, Vector4* out, size_t count);
+void TransformVectorsSSE(const Matrix4& transform, const Vector4* in, Vector4* out, size_t count);
+void TransformVectorsAVX2(const Matrix4& transform, const Vector4* in, Vector4* out, size_t count);
+
+void NormalizeVectorsScalar(const Vector4* in, Vector4* out, size_t count);
+void NormalizeVectorsSSE(const Vector4* in, Vector4* out, size_t count);
+void NormalizeVectorsAVX2(const Vector4* in, Vector4* out, size_t count);
+
+void LerpVectorsScalar(const Vector4* a, const Vector4* b, f32 t, Vector4* out, size_t count);
+void LerpVectorsSSE(const Vector4* a, const Vector4* b, f32 t, Vector4* out, size_t count);
+void LerpVectorsAVX2(const Vector4* a, const Vector4* b, f32 t, Vector4* out, size_t count);
@@ -0,0 +1,67 @@
+#include "cpu.h"
+
+#include "basic_types.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+static void CpuId(s32 leaf, s32 subleaf, u32 regs[4])
+{
+#   if defined(_MSC_VER)
+    __cpuidex((int*) regs, leaf, subleaf);
+#   else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#   endif
+}
+
+static u64 ReadXCR0()
+{
+#   if defined(_MSC_VER)
+    return _xgetbv(0);
+#   else
+    u32 eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((u64) edx << 32) | eax;
+#   endif
+}
+
+static CpuFeatures QueryCpuFeatures()
+{
+    CpuFeatures features;
+    u32 regs[4];    // eax, ebx, ecx, edx
+
+    CpuId(0, 0, regs);
+    u32 maxLeaf = regs[0];
+
+    if (maxLeaf < 1)
+        return features;
+
+    CpuId(1, 0, regs);
+    features.sse41 = (regs[2] >> 19) & 1;
+    features.fma   = (regs[2] >> 12) & 1;
+
+    bool osxsave = (regs[2] >> 27) & 1;
+    bool avx     = (regs[2] >> 28) & 1;
+
+    // The OS has to save xmm and ymm state on context switches
+    bool ymmEnabled = osxsave && (ReadXCR0() & 0x6) == 0x6;
+    features.avx = avx && ymmEnabled;
+    features.fma = features.fma && features.avx;
+
+    if (maxLeaf >= 7)
+    {
+        CpuId(7, 0, regs);
+        features.avx2 = features.avx && ((regs[1] >> 5) & 1);
+    }
+
+    return features;
+}
+
+const CpuFeatures& GetCpuFeatures()
+{
+    static const CpuFeatures features = QueryCpuFeatures();
+    return features;
+}
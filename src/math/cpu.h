@@ -0,0 +1,23 @@
+#pragma once
+
+#include "basic_types.h"
+
+// MSVC lets any function use any intrinsic, GCC and Clang need the target enabled per function.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define GN_TARGET_SSE41
+#define GN_TARGET_AVX2_FMA
+#else
+#define GN_TARGET_SSE41    __attribute__((target("sse4.1")))
+#define GN_TARGET_AVX2_FMA __attribute__((target("avx2,fma")))
+#endif
+
+struct CpuFeatures
+{
+    bool sse41 = false;
+    bool avx   = false;     // Also requires the OS to save ymm registers
+    bool avx2  = false;
+    bool fma   = false;
+};
+
+// Queried once with cpuid, safe to call from any thread
+const CpuFeatures& GetCpuFeatures();
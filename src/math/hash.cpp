@@ -5,42 +5,25 @@
 #include "vecs/vector3.h"
 #include "vecs/vector4.h"
 
-static void CombineHash(size_t& seed, size_t hash)
-{
-    // Copied from glm
-    hash += 0x9e3779b9 + (seed << 6) + (seed >> 2);
-    seed ^= hash;
-}
-
 namespace gn
 {
     size_t hash<Vector2>::operator()(Vector2 const& vec) const
     {
-        size_t seed = 0;
-        hash<f32> hasher;
-        CombineHash(seed, hasher(vec.x));
-        CombineHash(seed, hasher(vec.y));
-        return seed;
+        // Both components fit in a single word
+        u64 bits = (hash_f32_bits(vec.x) << 32) | hash_f32_bits(vec.y);
+        return hash_u64(bits);
     }
 
     size_t hash<Vector3>::operator()(Vector3 const& vec) const
     {
-        size_t seed = 0;
-        hash<f32> hasher;
-        CombineHash(seed, hasher(vec.x));
-        CombineHash(seed, hasher(vec.y));
-        CombineHash(seed, hasher(vec.z));
-        return seed;
+        u64 xy = (hash_f32_bits(vec.x) << 32) | hash_f32_bits(vec.y);
+        return hash_combine(hash_u64(xy), hash_f32_bits(vec.z));
     }
 
     size_t hash<Vector4>::operator()(Vector4 const& vec) const
     {
-        size_t seed = 0;
-        hash<f32> hasher;
-        CombineHash(seed, hasher(vec.x));
-        CombineHash(seed, hasher(vec.y));
-        CombineHash(seed, hasher(vec.z));
-        CombineHash(seed, hasher(vec.w));
-        return seed;
+        u64 xy = (hash_f32_bits(vec.x) << 32) | hash_f32_bits(vec.y);
+        u64 zw = (hash_f32_bits(vec.z) << 32) | hash_f32_bits(vec.w);
+        return hash_combine(hash_u64(xy), zw);
     }
 }
\ No newline at end of file
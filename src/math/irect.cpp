@@ -0,0 +1,245 @@
+#include "irect.h"
+
+#include <algorithm>
+#include <climits>
+#include <smmintrin.h>
+#include "basic_types.h"
+#include "cpu.h"
+
+IRect IRectFromCorners(s32 minX, s32 minY, s32 maxX, s32 maxY)
+{
+    return IRect(minX, minY, maxX - minX, maxY - minY);
+}
+
+IRect Intersect(const IRect& a, const IRect& b)
+{
+    s32 x = std::max(a.x, b.x);
+    s32 y = std::max(a.y, b.y);
+
+    s32 width  = std::max(std::min(a.MaxX(), b.MaxX()) - x, 0);
+    s32 height = std::max(std::min(a.MaxY(), b.MaxY()) - y, 0);
+
+    return IRect(x, y, width, height);
+}
+
+IRect Union(const IRect& a, const IRect& b)
+{
+    if (a.Empty())
+        return b.Empty() ? IRect() : b;
+
+    if (b.Empty())
+        return a;
+
+    return IRectFromCorners(std::min(a.x, b.x), std::min(a.y, b.y),
+                            std::max(a.MaxX(), b.MaxX()), std::max(a.MaxY(), b.MaxY()));
+}
+
+bool Contains(const IRect& rect, s32 x, s32 y)
+{
+    return x >= rect.x && x < rect.MaxX() &&
+           y >= rect.y && y < rect.MaxY();
+}
+
+bool Contains(const IRect& outer, const IRect& inner)
+{
+    return inner.x >= outer.x && inner.MaxX() <= outer.MaxX() &&
+           inner.y >= outer.y && inner.MaxY() <= outer.MaxY();
+}
+
+bool Overlaps(const IRect& a, const IRect& b)
+{
+    return !a.Empty() && !b.Empty() &&
+           a.x < b.MaxX() && b.x < a.MaxX() &&
+           a.y < b.MaxY() && b.y < a.MaxY();
+}
+
+IRect ClipToImage(const IRect& rect, s32 imageWidth, s32 imageHeight)
+{
+    return Intersect(rect, IRect(0, 0, imageWidth, imageHeight));
+}
+
+static inline IRect* RectAt(IRect* rects, size_t stride, size_t index)
+{
+    return (IRect*) ((u8*) rects + index * stride);
+}
+
+static inline const IRect* RectAt(const IRect* rects, size_t stride, size_t index)
+{
+    return (const IRect*) ((const u8*) rects + index * stride);
+}
+
+// Scalar
+
+static void ClipRectsScalar(IRect* rects, size_t stride, size_t count, const IRect& clip)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        IRect* rect = RectAt(rects, stride, i);
+        *rect = Intersect(*rect, clip);
+    }
+}
+
+static IRect UnionRectsScalar(const IRect* rects, size_t stride, size_t count)
+{
+    IRect result;
+    for (size_t i = 0; i < count; i++)
+        result = Union(result, *RectAt(rects, stride, i));
+
+    return result;
+}
+
+static void OverlapMaskScalar(const IRect* rects, size_t stride, size_t count, const IRect& query, u8* out)
+{
+    for (size_t i = 0; i < count; i++)
+        out[i] = Overlaps(*RectAt(rects, stride, i), query);
+}
+
+static s64 FindFirstOverlapScalar(const IRect* rects, size_t stride, size_t count, const IRect& query)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (Overlaps(*RectAt(rects, stride, i), query))
+            return (s64) i;
+    }
+
+    return -1;
+}
+
+// SSE4.1, one rect per register. Rects are turned into corners (x, y, maxX, maxY)
+// so intersect and union become a single min and max.
+
+GN_TARGET_SSE41
+static inline __m128i LoadCorners(const IRect* rect)
+{
+    __m128i v = _mm_loadu_si128((const __m128i*) rect);
+    return _mm_add_epi32(v, _mm_slli_si128(v, 8));
+}
+
+GN_TARGET_SSE41
+static inline __m128i CornersToRect(__m128i corners)
+{
+    return _mm_sub_epi32(corners, _mm_slli_si128(corners, 8));
+}
+
+GN_TARGET_SSE41
+static inline bool OverlapsCorners(__m128i corners, __m128i querySwapped)
+{
+    // (x, y, qx, qy) < (qmaxX, qmaxY, maxX, maxY), querySwapped is (qmaxX, qmaxY, qx, qy)
+    __m128i left  = _mm_blend_epi16(corners, querySwapped, 0xF0);
+    __m128i right = _mm_blend_epi16(querySwapped, corners, 0xF0);
+
+    // Also rejects empty rects, maxX > x and maxY > y
+    __m128i swapped  = _mm_shuffle_epi32(corners, _MM_SHUFFLE(1, 0, 3, 2));
+    __m128i nonEmpty = _mm_cmpgt_epi32(swapped, corners);
+
+    __m128i result = _mm_and_si128(_mm_cmpgt_epi32(right, left),
+                                   _mm_unpacklo_epi64(nonEmpty, nonEmpty));
+
+    return _mm_movemask_ps(_mm_castsi128_ps(result)) == 0xF;
+}
+
+GN_TARGET_SSE41
+static void ClipRectsSSE41(IRect* rects, size_t stride, size_t count, const IRect& clip)
+{
+    const __m128i clipCorners = LoadCorners(&clip);
+    const __m128i minSize = _mm_setr_epi32(INT_MIN, INT_MIN, 0, 0);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        IRect* rect = RectAt(rects, stride, i);
+        __m128i corners = LoadCorners(rect);
+
+        // Max of the min corners, min of the max corners
+        __m128i clipped = _mm_blend_epi16(_mm_max_epi32(corners, clipCorners),
+                                          _mm_min_epi32(corners, clipCorners), 0xF0);
+
+        _mm_storeu_si128((__m128i*) rect, _mm_max_epi32(CornersToRect(clipped), minSize));
+    }
+}
+
+GN_TARGET_SSE41
+static IRect UnionRectsSSE41(const IRect* rects, size_t stride, size_t count)
+{
+    __m128i low  = _mm_set1_epi32(INT_MAX);
+    __m128i high = _mm_set1_epi32(INT_MIN);
+    bool any = false;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const IRect* rect = RectAt(rects, stride, i);
+        if (rect->Empty())
+            continue;
+
+        __m128i corners = LoadCorners(rect);
+        low  = _mm_min_epi32(low, corners);
+        high = _mm_max_epi32(high, corners);
+        any = true;
+    }
+
+    if (!any)
+        return IRect();
+
+    IRect result;
+    _mm_storeu_si128((__m128i*) &result, CornersToRect(_mm_blend_epi16(low, high, 0xF0)));
+    return result;
+}
+
+GN_TARGET_SSE41
+static void OverlapMaskSSE41(const IRect* rects, size_t stride, size_t count, const IRect& query, u8* out)
+{
+    if (query.Empty())
+    {
+        for (size_t i = 0; i < count; i++)
+            out[i] = 0;
+
+        return;
+    }
+
+    const __m128i querySwapped = _mm_shuffle_epi32(LoadCorners(&query), _MM_SHUFFLE(1, 0, 3, 2));
+
+    for (size_t i = 0; i < count; i++)
+        out[i] = OverlapsCorners(LoadCorners(RectAt(rects, stride, i)), querySwapped);
+}
+
+GN_TARGET_SSE41
+static s64 FindFirstOverlapSSE41(const IRect* rects, size_t stride, size_t count, const IRect& query)
+{
+    if (query.Empty())
+        return -1;
+
+    const __m128i querySwapped = _mm_shuffle_epi32(LoadCorners(&query), _MM_SHUFFLE(1, 0, 3, 2));
+
+    for (size_t i = 0; i < count; i++)
+    {
+        if (OverlapsCorners(LoadCorners(RectAt(rects, stride, i)), querySwapped))
+            return (s64) i;
+    }
+
+    return -1;
+}
+
+// Dispatch
+
+void ClipRects(IRect* rects, size_t stride, size_t count, const IRect& clip)
+{
+    static const auto impl = GetCpuFeatures().sse41 ? ClipRectsSSE41 : ClipRectsScalar;
+    impl(rects, stride, count, clip);
+}
+
+IRect UnionRects(const IRect* rects, size_t stride, size_t count)
+{
+    static const auto impl = GetCpuFeatures().sse41 ? UnionRectsSSE41 : UnionRectsScalar;
+    return impl(rects, stride, count);
+}
+
+void OverlapMask(const IRect* rects, size_t stride, size_t count, const IRect& query, u8* out)
+{
+    static const auto impl = GetCpuFeatures().sse41 ? OverlapMaskSSE41 : OverlapMaskScalar;
+    impl(rects, stride, count, query, out);
+}
+
+s64 FindFirstOverlap(const IRect* rects, size_t stride, size_t count, const IRect& query)
+{
+    static const auto impl = GetCpuFeatures().sse41 ? FindFirstOverlapSSE41 : FindFirstOverlapScalar;
+    return impl(rects, stride, count, query);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include "basic_types.h"
+
+// Pixel rect with integer fields, covering [x, x + width) x [y, y + height).
+// The axis direction is up to the user, min corner and size are all that's stored.
+struct IRect
+{
+    s32 x = 0, y = 0;
+    s32 width = 0, height = 0;
+
+    IRect() = default;
+
+    IRect(s32 x, s32 y, s32 width, s32 height)
+    :   x(x), y(y), width(width), height(height) {}
+
+    inline s32 MaxX() const { return x + width; }
+    inline s32 MaxY() const { return y + height; }
+
+    inline bool Empty() const { return width <= 0 || height <= 0; }
+
+    inline bool operator==(const IRect& other) const
+    {
+        return x == other.x && y == other.y &&
+               width == other.width && height == other.height;
+    }
+
+    inline bool operator!=(const IRect& other) const
+    {
+        return !(*this == other);
+    }
+};
+
+// Corners are inclusive at the min end and exclusive at the max end
+IRect IRectFromCorners(s32 minX, s32 minY, s32 maxX, s32 maxY);
+
+// Empty results have 0 width and height
+IRect Intersect(const IRect& a, const IRect& b);
+
+// Bounding rect of both, empty rects are ignored
+IRect Union(const IRect& a, const IRect& b);
+
+bool Contains(const IRect& rect, s32 x, s32 y);
+bool Contains(const IRect& outer, const IRect& inner);
+bool Overlaps(const IRect& a, const IRect& b);
+
+IRect ClipToImage(const IRect& rect, s32 imageWidth, s32 imageHeight);
+
+// Batch operations. Rects are read every stride bytes so arrays of structs that start
+// with an IRect can be passed as they are, as well as plain IRect arrays.
+// Dispatched at runtime, SSE4.1 with a scalar fallback.
+
+// Intersects every rect with clip in place, clipping frames to the image bounds for example
+void ClipRects(IRect* rects, size_t stride, size_t count, const IRect& clip);
+
+// Bounding rect of all non empty rects
+IRect UnionRects(const IRect* rects, size_t stride, size_t count);
+
+// out[i] is 1 if rect i overlaps query, 0 otherwise
+void OverlapMask(const IRect* rects, size_t stride, size_t count, const IRect& query, u8* out);
+
+// Index of the first rect that overlaps query, -1 if none do.
+// Pass a 1x1 query to hit test a pixel.
+s64 FindFirstOverlap(const IRect* rects, size_t stride, size_t count, const IRect& query);
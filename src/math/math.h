@@ -6,6 +6,27 @@
 #define _PI_180   0.01745329251994329577f   // pi / 180
 #define _180_PI   57.2957795130823208768f   // 180 / pi
 
-f32 Clamp(f32 val, f32 min, f32 max);
-f32 ToRad(f32 deg);
-f32 ToDeg(f32 rad);
\ No newline at end of file
+// True while the compiler evaluates a constant expression, so constexpr math can take
+// a scalar path at compile time and keep its SIMD path at runtime.
+// std::is_constant_evaluated needs C++20, the builtin is there in C++17 on MSVC 19.25+, GCC 9+ and Clang 9+.
+#define GN_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+
+constexpr f32 Clamp(f32 val, f32 min, f32 max)
+{
+    if (val < min)
+        return min;
+    if (val > max)
+        return max;
+
+    return val;
+}
+
+constexpr f32 ToRad(f32 deg)
+{
+    return deg * _PI_180;
+}
+
+constexpr f32 ToDeg(f32 rad)
+{
+    return rad * _180_PI;
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <cmath>
+#include <xmmintrin.h>
+#include "../basic_types.h"
+#include "../vecs/vector2.h"
+
+// 2D affine transform, the top two rows of a 3x3 matrix.
+// Stored column major like Matrix4 so data can be uploaded as a GLSL mat3x2:
+// sseData[0] holds the linear part (x axis, y axis), sseData[1] the translation in its low half.
+union Matrix3x2
+{
+    f32 data[8];    // 6 used, padded to two registers
+    __m128 sseData[2];
+
+    constexpr Matrix3x2(f32 diagonal = 1.0f)
+    :   Matrix3x2(diagonal, diagonal, 0.0f, 0.0f) {}
+
+    constexpr Matrix3x2(f32 scaleX, f32 scaleY, f32 translationX, f32 translationY)
+    :   data { scaleX, 0.0f, 0.0f, scaleY, translationX, translationY, 0.0f, 0.0f } {}
+
+    constexpr Matrix3x2(__m128 linear, __m128 translation)
+    :   sseData { linear, translation } {}
+
+    static constexpr Matrix3x2 Translation(const Vector2& displacement)
+    {
+        return Matrix3x2(1.0f, 1.0f, displacement.x, displacement.y);
+    }
+
+    static constexpr Matrix3x2 Scaling(f32 scale)
+    {
+        return Matrix3x2(scale);
+    }
+
+    static constexpr Matrix3x2 Scaling(const Vector2& scale)
+    {
+        return Matrix3x2(scale.x, scale.y, 0.0f, 0.0f);
+    }
+
+    static inline Matrix3x2 Rotation(f32 angle)
+    {
+        f32 st = sinf(angle);
+        f32 ct = cosf(angle);
+
+        return Matrix3x2(_mm_setr_ps(ct, st, -st, ct), _mm_setzero_ps());
+    }
+
+    // Maps top left origin pixels to [-1, 1] with y going up
+    static constexpr Matrix3x2 ScreenToNDC(f32 width, f32 height)
+    {
+        return Matrix3x2(2.0f / width, -2.0f / height, -1.0f, 1.0f);
+    }
+
+    constexpr Vector2 GetTranslation() const
+    {
+        return Vector2(data[4], data[5]);
+    }
+
+    // Applies right first, then this
+    inline Matrix3x2 operator*(const Matrix3x2& right) const
+    {
+        // Columns of this repeated: (a0, a1, a0, a1) and (a2, a3, a2, a3)
+        __m128 xAxis = _mm_movelh_ps(sseData[0], sseData[0]);
+        __m128 yAxis = _mm_movehl_ps(sseData[0], sseData[0]);
+
+        __m128 linear = _mm_add_ps(_mm_mul_ps(xAxis, _mm_shuffle_ps(right.sseData[0], right.sseData[0], _MM_SHUFFLE(2, 2, 0, 0))),
+                                   _mm_mul_ps(yAxis, _mm_shuffle_ps(right.sseData[0], right.sseData[0], _MM_SHUFFLE(3, 3, 1, 1))));
+
+        __m128 translation = _mm_add_ps(_mm_mul_ps(xAxis, _mm_shuffle_ps(right.sseData[1], right.sseData[1], _MM_SHUFFLE(0, 0, 0, 0))),
+                                        _mm_mul_ps(yAxis, _mm_shuffle_ps(right.sseData[1], right.sseData[1], _MM_SHUFFLE(1, 1, 1, 1))));
+        translation = _mm_add_ps(translation, sseData[1]);
+
+        // Keep the padding at 0
+        translation = _mm_movelh_ps(translation, _mm_setzero_ps());
+
+        return Matrix3x2(linear, translation);
+    }
+
+    inline Matrix3x2& operator*=(const Matrix3x2& right)
+    {
+        *this = *this * right;
+        return *this;
+    }
+
+    constexpr Vector2 operator*(const Vector2& point) const
+    {
+        return Vector2(data[0] * point.x + data[2] * point.y + data[4],
+                       data[1] * point.x + data[3] * point.y + data[5]);
+    }
+
+    // Ignores the translation, for directions and sizes
+    constexpr Vector2 TransformVector(const Vector2& vector) const
+    {
+        return Vector2(data[0] * vector.x + data[2] * vector.y,
+                       data[1] * vector.x + data[3] * vector.y);
+    }
+};
+
+constexpr f32 Determinant(const Matrix3x2& mat)
+{
+    return mat.data[0] * mat.data[3] - mat.data[2] * mat.data[1];
+}
+
+inline Matrix3x2 Inverse(const Matrix3x2& mat)
+{
+    f32 det = Determinant(mat);
+    if (det == 0.0f)
+        return Matrix3x2();
+
+    // Inverse of the linear part is (d, -b, -c, a) / det
+    __m128 linear = _mm_shuffle_ps(mat.sseData[0], mat.sseData[0], _MM_SHUFFLE(0, 2, 1, 3));
+    linear = _mm_mul_ps(linear, _mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f));
+    linear = _mm_div_ps(linear, _mm_set1_ps(det));
+
+    Matrix3x2 result(linear, _mm_setzero_ps());
+
+    // Translation is -inverse(linear) * translation
+    Vector2 translation = result.TransformVector(mat.GetTranslation());
+    result.sseData[1] = _mm_setr_ps(-translation.x, -translation.y, 0.0f, 0.0f);
+
+    return result;
+}
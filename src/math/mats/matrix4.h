@@ -2,6 +2,7 @@
 
 #include <xmmintrin.h>
 #include "../basic_types.h"
+#include "../math.h"
 #include "../vecs/vector3.h"
 #include "../vecs/vector4.h"
 
@@ -15,38 +16,27 @@ union Matrix4
         return Vector4(sseColumns[index]);
     }
 
-    Matrix4(f32 diagonal = 1.0f)
-    {
-        sseColumns[0] = _mm_setr_ps(diagonal, 0.0f, 0.0f, 0.0f);
-        sseColumns[1] = _mm_setr_ps(0.0f, diagonal, 0.0f, 0.0f);
-        sseColumns[2] = _mm_setr_ps(0.0f, 0.0f, diagonal, 0.0f);
-        sseColumns[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, diagonal);
-    }
+    constexpr Matrix4(f32 diagonal = 1.0f)
+    :   Matrix4(diagonal, diagonal, diagonal, diagonal) {}
 
-    Matrix4(f32 d1, f32 d2, f32 d3, f32 d4 = 1.0f)
-    {
-        sseColumns[0] = _mm_setr_ps(d1, 0.0f, 0.0f, 0.0f);
-        sseColumns[1] = _mm_setr_ps(0.0f, d2, 0.0f, 0.0f);
-        sseColumns[2] = _mm_setr_ps(0.0f, 0.0f, d3, 0.0f);
-        sseColumns[3] = _mm_setr_ps(0.0f, 0.0f, 0.0f, d4);
-    }
+    constexpr Matrix4(f32 d1, f32 d2, f32 d3, f32 d4 = 1.0f)
+    :   data { { d1,   0.0f, 0.0f, 0.0f },
+               { 0.0f, d2,   0.0f, 0.0f },
+               { 0.0f, 0.0f, d3,   0.0f },
+               { 0.0f, 0.0f, 0.0f, d4   } } {}
 
-    Matrix4(__m128 c0, __m128 c1, __m128 c2, __m128 c3)
-    {
-        sseColumns[0] = c0;
-        sseColumns[1] = c1;
-        sseColumns[2] = c2;
-        sseColumns[3] = c3;
-    }
+    constexpr Matrix4(__m128 c0, __m128 c1, __m128 c2, __m128 c3)
+    :   sseColumns { c0, c1, c2, c3 } {}
 
-    static inline Matrix4 Translation(const Vector3& displacement)
+    static constexpr Matrix4 Translation(const Vector3& displacement)
     {
-        __m128 c0 = _mm_setr_ps(1.0f, 0.0f, 0.0f, 0.0f);
-        __m128 c1 = _mm_setr_ps(0.0f, 1.0f, 0.0f, 0.0f);
-        __m128 c2 = _mm_setr_ps(0.0f, 0.0f, 1.0f, 0.0f);
-        __m128 c3 = _mm_setr_ps(displacement.x, displacement.y, displacement.z, 1.0f);
+        Matrix4 m(1.0f);
 
-        return Matrix4(c0, c1, c2, c3);
+        m.data[3][0] = displacement.x;
+        m.data[3][1] = displacement.y;
+        m.data[3][2] = displacement.z;
+
+        return m;
     }
 
     static inline Matrix4 Rotation(Vector3 axis, f32 angle)
@@ -85,12 +75,12 @@ union Matrix4
         return Matrix4(c0, c1, c2, c3);
     }
 
-    static inline Matrix4 Scaling(f32 scale)
+    static constexpr Matrix4 Scaling(f32 scale)
     {
         return Matrix4(scale, scale, scale);
     }
 
-    static inline Matrix4 Scaling(const Vector3& scale)
+    static constexpr Matrix4 Scaling(const Vector3& scale)
     {
         return Matrix4(scale.x, scale.y, scale.z);
     }
@@ -110,7 +100,7 @@ union Matrix4
         return m;
     }
 
-    static inline Matrix4 Orthographic(f32 left, f32 right, f32 bottom, f32 top, f32 near, f32 far)
+    static constexpr Matrix4 Orthographic(f32 left, f32 right, f32 bottom, f32 top, f32 near, f32 far)
     {
         Matrix4 m(1.0f);
 
@@ -203,8 +193,17 @@ union Matrix4
         return res;
     }
 
-    inline Vector4 operator*(const Vector4& vec) const
+    constexpr Vector4 operator*(const Vector4& vec) const
     {
+        if (GN_IS_CONSTANT_EVALUATED())
+        {
+            f32 res[4] = {};
+            for (int row = 0; row < 4; row++)
+                res[row] = data[0][row] * vec.x + data[1][row] * vec.y + data[2][row] * vec.z + data[3][row] * vec.w;
+
+            return Vector4(res[0], res[1], res[2], res[3]);
+        }
+
         return Vector4(*this * vec.sseData);
     }
 
@@ -214,8 +213,23 @@ union Matrix4
         return Vector3(res.x, res.y, res.z);
     }
 
-    inline Matrix4 operator*(const Matrix4& right) const
+    constexpr Matrix4 operator*(const Matrix4& right) const
     {
+        if (GN_IS_CONSTANT_EVALUATED())
+        {
+            Matrix4 res(0.0f);
+            for (int col = 0; col < 4; col++)
+            {
+                for (int row = 0; row < 4; row++)
+                {
+                    for (int k = 0; k < 4; k++)
+                        res.data[col][row] += data[k][row] * right.data[col][k];
+                }
+            }
+
+            return res;
+        }
+
         __m128 c0 = *this * right.sseColumns[0];
         __m128 c1 = *this * right.sseColumns[1];
         __m128 c2 = *this * right.sseColumns[2];
@@ -8,4 +8,5 @@
 
 #include "quats/quaternion.h"
 
+#include "mats/matrix3x2.h"
 #include "mats/matrix4.h"
\ No newline at end of file
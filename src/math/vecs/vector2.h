@@ -23,21 +23,21 @@ union Vector2
 
     f32 data[2];
 
-    inline f32& operator[](s32 index)
+    constexpr f32& operator[](s32 index)
     {
         return data[index];
     }
 
-    Vector2()
+    constexpr Vector2()
     :   x(0.0f), y(0.0f) {}
 
-    Vector2(f32 val)
+    constexpr Vector2(f32 val)
     :   x(val), y(val) {}
 
-    Vector2(f32 x, f32 y)
+    constexpr Vector2(f32 x, f32 y)
     :   x(x), y(y) {}
 
-    inline f32 SqrLength() const
+    constexpr f32 SqrLength() const
     {
         return x * x + y * y;
     }
@@ -70,7 +70,7 @@ union Vector2
         return *this;
     }
 
-    inline Vector2& operator-()
+    constexpr Vector2& operator-()
     {
         x = -x;
         y = -y;
@@ -78,7 +78,7 @@ union Vector2
         return *this;
     }
 
-    inline Vector2& operator+=(const Vector2& other)
+    constexpr Vector2& operator+=(const Vector2& other)
     {
         x += other.x;
         y += other.y;
@@ -86,7 +86,7 @@ union Vector2
         return *this;
     }
 
-    inline Vector2& operator-=(const Vector2& other)
+    constexpr Vector2& operator-=(const Vector2& other)
     {
         x -= other.x;
         y -= other.y;
@@ -94,7 +94,7 @@ union Vector2
         return *this;
     }
 
-    inline Vector2& operator*=(f32 scalar)
+    constexpr Vector2& operator*=(f32 scalar)
     {
         x *= scalar;
         y *= scalar;
@@ -102,7 +102,7 @@ union Vector2
         return *this;
     }
 
-    inline Vector2& operator/=(f32 scalar)
+    constexpr Vector2& operator/=(f32 scalar)
     {
         x /= scalar;
         y /= scalar;
@@ -110,48 +110,48 @@ union Vector2
         return *this;
     }
 
-    inline bool operator==(const Vector2& right) const
+    constexpr bool operator==(const Vector2& right) const
     {
         return x == right.x && y == right.y;
     }
 
-    inline bool operator!=(const Vector2& right) const
+    constexpr bool operator!=(const Vector2& right) const
     {
         return x != right.x || y != right.y;
     }
 };
 
-inline Vector2 operator+(const Vector2& left, const Vector2& right)
+constexpr Vector2 operator+(const Vector2& left, const Vector2& right)
 {
     return Vector2(left.x + right.x, left.y + right.y);
 }
 
-inline Vector2 operator-(const Vector2& left, const Vector2& right)
+constexpr Vector2 operator-(const Vector2& left, const Vector2& right)
 {
     return Vector2(left.x - right.x, left.y - right.y);
 }
 
-inline Vector2 operator*(const Vector2& vec, f32 scalar)
+constexpr Vector2 operator*(const Vector2& vec, f32 scalar)
 {
     return Vector2(vec.x * scalar, vec.y * scalar);
 }
 
-inline Vector2 operator*(f32 scalar, const Vector2& vec)
+constexpr Vector2 operator*(f32 scalar, const Vector2& vec)
 {
     return Vector2(vec.x * scalar, vec.y * scalar);
 }
 
-inline Vector2 operator/(const Vector2& vec, f32 scalar)
+constexpr Vector2 operator/(const Vector2& vec, f32 scalar)
 {
     return Vector2(vec.x / scalar, vec.y / scalar);
 }
 
-inline f32 Dot(const Vector2& left, const Vector2& right)
+constexpr f32 Dot(const Vector2& left, const Vector2& right)
 {
     return left.x * right.x + left.y * right.y;
 }
 
-inline f32 SqrDistance(const Vector2& v1, const Vector2& v2)
+constexpr f32 SqrDistance(const Vector2& v1, const Vector2& v2)
 {
     return (v1 - v2).SqrLength();
 }
@@ -161,7 +161,7 @@ inline f32 Distance(const Vector2& v1, const Vector2& v2)
     return (v1 - v2).Length();
 }
 
-inline Vector2 Lerp(const Vector2& a, const Vector2& b, f32 t)
+constexpr Vector2 Lerp(const Vector2& a, const Vector2& b, f32 t)
 {
     t = Clamp(t, 0.0f, 1.0f);
     f32 _1_t = 1.0f - t;
@@ -18,21 +18,21 @@ union Vector3
 
     f32 data[3];
 
-    inline f32& operator[](s32 index)
+    constexpr f32& operator[](s32 index)
     {
         return data[index];
     }
 
-    Vector3()
+    constexpr Vector3()
     :   x(0.0f), y(0.0f), z(0.0f) {}
 
-    Vector3(f32 val)
+    constexpr Vector3(f32 val)
     :   x(val), y(val), z(val) {}
 
-    Vector3(f32 x, f32 y, f32 z)
+    constexpr Vector3(f32 x, f32 y, f32 z)
     :   x(x), y(y), z(z) {}
 
-    inline f32 SqrLength() const
+    constexpr f32 SqrLength() const
     {
         return x * x + y * y + z * z;
     }
@@ -66,7 +66,7 @@ union Vector3
         return *this;
     }
 
-    inline Vector3& operator-()
+    constexpr Vector3& operator-()
     {
         x = -x;
         y = -y;
@@ -75,7 +75,7 @@ union Vector3
         return *this;
     }
 
-    inline Vector3& operator+=(const Vector3& other)
+    constexpr Vector3& operator+=(const Vector3& other)
     {
         x += other.x;
         y += other.y;
@@ -84,7 +84,7 @@ union Vector3
         return *this;
     }
 
-    inline Vector3& operator-=(const Vector3& other)
+    constexpr Vector3& operator-=(const Vector3& other)
     {
         x -= other.x;
         y -= other.y;
@@ -93,7 +93,7 @@ union Vector3
         return *this;
     }
 
-    inline Vector3& operator*=(f32 scalar)
+    constexpr Vector3& operator*=(f32 scalar)
     {
         x *= scalar;
         y *= scalar;
@@ -102,7 +102,7 @@ union Vector3
         return *this;
     }
 
-    inline Vector3& operator/=(f32 scalar)
+    constexpr Vector3& operator/=(f32 scalar)
     {
         x /= scalar;
         y /= scalar;
@@ -111,53 +111,53 @@ union Vector3
         return *this;
     }
 
-    inline bool operator==(const Vector3& right) const
+    constexpr bool operator==(const Vector3& right) const
     {
         return x == right.x && y == right.y && z == right.z;
     }
 
-    inline bool operator!=(const Vector3& right) const
+    constexpr bool operator!=(const Vector3& right) const
     {
         return x != right.x || y != right.y || z != right.z;
     }
 };
 
-inline Vector3 operator+(const Vector3& left, const Vector3& right)
+constexpr Vector3 operator+(const Vector3& left, const Vector3& right)
 {
     return Vector3(left.x + right.x, left.y + right.y, left.z + right.z);
 }
 
-inline Vector3 operator-(const Vector3& left, const Vector3& right)
+constexpr Vector3 operator-(const Vector3& left, const Vector3& right)
 {
     return Vector3(left.x - right.x, left.y - right.y, left.z - right.z);
 }
 
-inline Vector3 operator*(const Vector3& vec, f32 scalar)
+constexpr Vector3 operator*(const Vector3& vec, f32 scalar)
 {
     return Vector3(vec.x * scalar, vec.y * scalar, vec.z * scalar);
 }
 
-inline Vector3 operator*(f32 scalar, const Vector3& vec)
+constexpr Vector3 operator*(f32 scalar, const Vector3& vec)
 {
     return Vector3(vec.x * scalar, vec.y * scalar, vec.z * scalar);
 }
 
-inline Vector3 operator/(const Vector3& vec, f32 scalar)
+constexpr Vector3 operator/(const Vector3& vec, f32 scalar)
 {
     return Vector3(vec.x / scalar, vec.y / scalar, vec.z / scalar);
 }
 
-inline Vector3 operator/(f32 scalar, const Vector3& vec)
+constexpr Vector3 operator/(f32 scalar, const Vector3& vec)
 {
     return Vector3(vec.x / scalar, vec.y / scalar, vec.z / scalar);
 }
 
-inline f32 Dot(const Vector3& left, const Vector3& right)
+constexpr f32 Dot(const Vector3& left, const Vector3& right)
 {
     return left.x * right.x + left.y * right.y + left.z * right.z;
 }
 
-inline Vector3 Cross(const Vector3& left, const Vector3& right)
+constexpr Vector3 Cross(const Vector3& left, const Vector3& right)
 {
     Vector3 v;
 
@@ -168,7 +168,7 @@ inline Vector3 Cross(const Vector3& left, const Vector3& right)
     return v;
 }
 
-inline f32 SqrDistance(const Vector3& v1, const Vector3& v2)
+constexpr f32 SqrDistance(const Vector3& v1, const Vector3& v2)
 {
     return (v1 - v2).SqrLength();
 }
@@ -178,7 +178,7 @@ inline f32 Distance(const Vector3& v1, const Vector3& v2)
     return (v1 - v2).Length();
 }
 
-inline Vector3 Lerp(const Vector3& a, const Vector3& b, f32 t)
+constexpr Vector3 Lerp(const Vector3& a, const Vector3& b, f32 t)
 {
     t = Clamp(t, 0.0f, 1.0f);
     f32 _1_t = 1.0f - t;
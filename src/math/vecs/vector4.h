@@ -6,7 +6,7 @@
 #include "../math.h"
 
 union Vector4;
-extern f32 Dot(const Vector4& left, const Vector4& right);
+constexpr f32 Dot(const Vector4& left, const Vector4& right);
 
 union Vector4
 {
@@ -29,24 +29,24 @@ union Vector4
 
     __m128 sseData;
 
-    inline f32& operator[](s32 index)
+    constexpr f32& operator[](s32 index)
     {
         return data[index];
     }
 
-    Vector4()
+    constexpr Vector4()
     :   x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
 
-    Vector4(__m128 sseData)
+    constexpr Vector4(__m128 sseData)
     :   sseData(sseData) {}
 
-    Vector4(f32 val)
+    constexpr Vector4(f32 val)
     :   x(val), y(val), z(val), w(val) {}
 
-    Vector4(f32 x, f32 y, f32 z, f32 w)
+    constexpr Vector4(f32 x, f32 y, f32 z, f32 w)
     :   x(x), y(y), z(z), w(w) {}
 
-    inline f32 SqrLength() const
+    constexpr f32 SqrLength() const
     {
         return Dot(*this, *this);
     }
@@ -87,74 +87,96 @@ union Vector4
         return *this;
     }
 
-    inline Vector4& operator+=(const Vector4& other)
-    {
-        sseData = _mm_add_ps(sseData, other.sseData);
-        return *this;
-    }
-
-    inline Vector4& operator-=(const Vector4& other)
-    {
-        sseData = _mm_sub_ps(sseData, other.sseData);
-        return *this;
-    }
-
-    inline Vector4& operator*=(f32 scalar)
-    {
-        _mm_mul_ps(sseData, _mm_set1_ps(scalar));
-        return *this;
-    }
+    constexpr Vector4& operator+=(const Vector4& other);
+    constexpr Vector4& operator-=(const Vector4& other);
+    constexpr Vector4& operator*=(f32 scalar);
+    constexpr Vector4& operator/=(f32 scalar);
 
-    inline Vector4& operator/=(f32 scalar)
-    {
-        _mm_div_ps(sseData, _mm_set1_ps(scalar));
-        return *this;
-    }
-
-    inline bool operator==(const Vector4& right) const
+    constexpr bool operator==(const Vector4& right) const
     {
         return x == right.x && y == right.y && z == right.z && w == right.w;
     }
 
-    inline bool operator!=(const Vector4& right) const
+    constexpr bool operator!=(const Vector4& right) const
     {
         return x != right.x || y != right.y || z != right.z || w != right.w;
     }
 };
 
-inline Vector4 operator+(const Vector4& left, const Vector4& right)
+// The operators below take the scalar path while being evaluated at compile time
+
+constexpr Vector4 operator+(const Vector4& left, const Vector4& right)
 {
+    if (GN_IS_CONSTANT_EVALUATED())
+        return Vector4(left.x + right.x, left.y + right.y, left.z + right.z, left.w + right.w);
+
     return Vector4(_mm_add_ps(left.sseData, right.sseData));
 }
 
-inline Vector4 operator-(const Vector4& left, const Vector4& right)
+constexpr Vector4 operator-(const Vector4& left, const Vector4& right)
 {
+    if (GN_IS_CONSTANT_EVALUATED())
+        return Vector4(left.x - right.x, left.y - right.y, left.z - right.z, left.w - right.w);
+
     return Vector4(_mm_sub_ps(left.sseData, right.sseData));
 }
 
-inline Vector4 operator*(const Vector4& vec, f32 scalar)
+constexpr Vector4 operator*(const Vector4& vec, f32 scalar)
 {
+    if (GN_IS_CONSTANT_EVALUATED())
+        return Vector4(vec.x * scalar, vec.y * scalar, vec.z * scalar, vec.w * scalar);
+
     return Vector4(_mm_mul_ps(vec.sseData, _mm_set1_ps(scalar)));
 }
 
-inline Vector4 operator*(f32 scalar, const Vector4& vec)
+constexpr Vector4 operator*(f32 scalar, const Vector4& vec)
 {
-    return Vector4(_mm_mul_ps(vec.sseData, _mm_set1_ps(scalar)));
+    return vec * scalar;
 }
 
-inline Vector4 operator/(const Vector4& vec, f32 scalar)
+constexpr Vector4 operator/(const Vector4& vec, f32 scalar)
 {
+    if (GN_IS_CONSTANT_EVALUATED())
+        return Vector4(vec.x / scalar, vec.y / scalar, vec.z / scalar, vec.w / scalar);
+
     return Vector4(_mm_div_ps(vec.sseData, _mm_set1_ps(scalar)));
 }
 
-inline Vector4 operator/(f32 scalar, const Vector4& vec)
+constexpr Vector4 operator/(f32 scalar, const Vector4& vec)
 {
-    return Vector4(_mm_div_ps(vec.sseData, _mm_set1_ps(scalar)));
+    return vec / scalar;
+}
+
+constexpr Vector4& Vector4::operator+=(const Vector4& other)
+{
+    *this = *this + other;
+    return *this;
+}
+
+constexpr Vector4& Vector4::operator-=(const Vector4& other)
+{
+    *this = *this - other;
+    return *this;
 }
 
-inline f32 Dot(const Vector4& left, const Vector4& right)
+constexpr Vector4& Vector4::operator*=(f32 scalar)
 {
-    f32 res;    
+    *this = *this * scalar;
+    return *this;
+}
+
+constexpr Vector4& Vector4::operator/=(f32 scalar)
+{
+    *this = *this / scalar;
+    return *this;
+}
+
+constexpr f32 Dot(const Vector4& left, const Vector4& right)
+{
+    if (GN_IS_CONSTANT_EVALUATED())
+        return left.x * right.x + left.y * right.y + left.z * right.z + left.w * right.w;
+
+    f32 res = 0.0f;
 
     // Copied from HandmadeMath
     __m128 SSEResultOne = _mm_mul_ps(left.sseData, right.sseData);
@@ -167,7 +189,7 @@ inline f32 Dot(const Vector4& left, const Vector4& right)
     return res;
 }
 
-inline f32 SqrDistance(const Vector4& v1, const Vector4& v2)
+constexpr f32 SqrDistance(const Vector4& v1, const Vector4& v2)
 {
     return (v1 - v2).SqrLength();
 }
@@ -177,8 +199,11 @@ inline f32 Distance(const Vector4& v1, const Vector4& v2)
     return (v1 - v2).Length();
 }
 
-inline Vector4 Lerp(const Vector4& a, const Vector4& b, f32 t)
+constexpr Vector4 Lerp(const Vector4& a, const Vector4& b, f32 t)
 {
+    if (GN_IS_CONSTANT_EVALUATED())
+        return a * (1.0f - t) + b * t;
+
     return Vector4(_mm_add_ps(
         _mm_mul_ps(a.sseData, _mm_set1_ps(1.0f - t)),
         _mm_mul_ps(b.sseData, _mm_set1_ps(t))
@@ -4,6 +4,8 @@
 #include <iostream>
 #endif
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <stb/stb_image.h>
 #include <glad/glad.h>
@@ -23,6 +25,9 @@ static u64 keyUpdateFlags[6] = { 0 };
 static f64 prevMouseX = 0.0;
 static f64 prevMouseY = 0.0;
 
+// Immediate mode widgets apply a click while the frame is drawn, one more frame shows the result
+static constexpr u32 framesAfterInput = 2;
+
 static void UpdateInputFlags()
 {
     mouseButtonWasPressedFlags = mouseButtonUpdateFlags;
@@ -40,6 +45,7 @@ static bool Initialize()
 static void CursorPositionCallback(GLFWwindow* window, f64 xpos, f64 ypos)
 {
     Application* app = (Application*) glfwGetWindowUserPointer(window);
+    app->pendingFrames = framesAfterInput;
 
     app->mouseX = (xpos / app->screenWidth)  * app->refScreenWidth;
     app->mouseY = (ypos / app->screenHeight) * app->refScreenHeight;
@@ -50,6 +56,7 @@ static void CursorPositionCallback(GLFWwindow* window, f64 xpos, f64 ypos)
 static void FramebufferSizeCallback(GLFWwindow* window, int width, int height)
 {
     Application* app = (Application*) glfwGetWindowUserPointer(window);
+    app->pendingFrames = framesAfterInput;
 
     app->screenWidth  = width;
     app->screenHeight = height;
@@ -65,21 +72,42 @@ static void FramebufferSizeCallback(GLFWwindow* window, int width, int height)
     glfwSwapBuffers(window);
 }
 
+static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    Application* app = (Application*) glfwGetWindowUserPointer(window);
+    app->pendingFrames = framesAfterInput;
+}
+
+static void MouseButtonCallback(GLFWwindow* window, int button, int action, int mods)
+{
+    Application* app = (Application*) glfwGetWindowUserPointer(window);
+    app->pendingFrames = framesAfterInput;
+}
+
+static void WindowRefreshCallback(GLFWwindow* window)
+{
+    Application* app = (Application*) glfwGetWindowUserPointer(window);
+    app->pendingFrames = framesAfterInput;
+}
+
 static void ScrollCallback(GLFWwindow* window, f64 xoffset, f64 yoffset)
 {
     Application* app = (Application*) glfwGetWindowUserPointer(window);
+    app->pendingFrames = framesAfterInput;
     app->scrollCallback(*app, xoffset, yoffset);
 }
 
 static void CharacterCallback(GLFWwindow* window, u32 codepoint)
 {
     Application* app = (Application*) glfwGetWindowUserPointer(window);
+    app->pendingFrames = framesAfterInput;
     app->charCallback(*app, codepoint);
 }
 
 static void DropCallback(GLFWwindow* window, s32 count, const char** paths)
 {
     Application* app = (Application*) glfwGetWindowUserPointer(window);
+    app->pendingFrames = framesAfterInput;
     app->dropCallback(*app, count, paths);
 }
 
@@ -105,6 +133,10 @@ Application::Application(const char* title, int width, int height, bool fullscre
     vsyncOn = false;
     deltaMouseX = deltaMouseY = 0.0;
 
+    redrawOnDemand = true;
+    pendingFrames = framesAfterInput;
+    nextRedrawTime = INFINITY;
+
     glfwMakeContextCurrent(window);
     
     onInit = onUpdate = onRender = windowResizeCallback = mousePositionCallback = [](Application&){};
@@ -118,6 +150,9 @@ Application::Application(const char* title, int width, int height, bool fullscre
     glfwSetCharCallback(window, CharacterCallback);
     glfwSetScrollCallback(window, ScrollCallback);
     glfwSetDropCallback(window, DropCallback);
+    glfwSetKeyCallback(window, KeyCallback);
+    glfwSetMouseButtonCallback(window, MouseButtonCallback);
+    glfwSetWindowRefreshCallback(window, WindowRefreshCallback);
 
     if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress))
         return;
@@ -163,12 +198,48 @@ Application::~Application()
 }
 
 
+// Returns once there's a reason to draw, any event wakes the loop up
+static void WaitForNextFrame(Application& app)
+{
+    if (!app.redrawOnDemand || app.pendingFrames > 0)
+    {
+        if (app.pendingFrames > 0)
+            app.pendingFrames--;
+
+        glfwPollEvents();
+        return;
+    }
+
+    f64 now = glfwGetTime();
+    f64 wakeTime = app.nextRedrawTime;
+    app.nextRedrawTime = INFINITY;
+
+    if (wakeTime <= now)
+        glfwPollEvents();
+    else if (wakeTime < INFINITY)
+        glfwWaitEventsTimeout(wakeTime - now);
+    else
+        glfwWaitEvents();
+}
+
 void Application::Run()
 {
+#   ifdef DEBUG
+    // glfwGetTime starts at glfwInit, before the window is made
+    f64 initStart = glfwGetTime();
+#   endif
+
     UI::Init();
 
     onInit(*this);
 
+#   ifdef DEBUG
+    f64 initEnd = glfwGetTime();
+    std::cout << "Startup: window " << initStart * 1000.0 << "ms, onInit " << (initEnd - initStart) * 1000.0 << "ms\n";
+
+    bool firstFrame = true;
+#   endif
+
     f64 prevTime = glfwGetTime();
 
     while (!glfwWindowShouldClose(window))
@@ -188,7 +259,16 @@ void Application::Run()
         onRender(*this);
 
         glfwSwapBuffers(window);
-        glfwPollEvents();
+
+#       ifdef DEBUG
+        if (firstFrame)
+        {
+            std::cout << "Startup: first frame shown at " << glfwGetTime() * 1000.0 << "ms\n";
+            firstFrame = false;
+        }
+#       endif
+
+        WaitForNextFrame(*this);
 
         UpdateInputFlags();
 
@@ -326,6 +406,26 @@ void Application::SetVsync(bool value)
     glfwSwapInterval((int) value);
 }
 
+void Application::SetRedrawOnDemand(bool value)
+{
+    redrawOnDemand = value;
+}
+
+void Application::RequestRedraw()
+{
+    pendingFrames = std::max(pendingFrames, 1u);
+}
+
+void Application::RequestRedrawAt(f64 time)
+{
+    nextRedrawTime = std::min(nextRedrawTime, time);
+}
+
+void Application::Wake()
+{
+    glfwPostEmptyEvent();
+}
+
 void Application::SetCaptureMouse(bool value)
 {
     int val = (value) ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL;
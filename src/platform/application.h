@@ -31,6 +31,13 @@ struct Application
     void SetClearColor(const Vector4& color);
     void SetMaximize(bool value);
 
+    // Frames are only drawn on demand: after input, when requested, or when woken.
+    // Otherwise Run blocks in glfwWaitEvents and the process idles.
+    void SetRedrawOnDemand(bool value);     // false draws continuously, for profiling
+    void RequestRedraw();                   // Draw another frame right after this one
+    void RequestRedrawAt(f64 time);         // Draw a frame once glfwGetTime reaches time
+    void Wake();                            // Thread safe, for async work that finished
+
     GLFWwindow* window;
     s64 screenWidth, screenHeight;
     s64 refScreenWidth, refScreenHeight;
@@ -40,6 +47,10 @@ struct Application
     f64 deltaMouseX, deltaMouseY;
     f64 time, deltaTime;
 
+    bool redrawOnDemand;
+    u32 pendingFrames;
+    f64 nextRedrawTime;
+
     void (*onInit)(Application& app);
     void (*onUpdate)(Application& app);
     void (*onRender)(Application& app);
@@ -1,12 +1,26 @@
 #include "fileio.h"
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <filesystem>
 #include <fstream>
 #include <string>
+#include <system_error>
 #include "containers/darray.h"
 #include "math/types.h"
 #include "misc/gn_assert.h"
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 std::string LoadFile(const std::string_view& filepath)
 {
     FILE* file = fopen(filepath.data(), "rb");
@@ -42,4 +56,118 @@ gn::darray<Byte> LoadBinaryFile(const std::string_view& filepath)
 
     fclose(file);
     return std::move(contents);
-}
\ No newline at end of file
+}
+
+bool MappedFile::Map(const std::string_view& filepath)
+{
+    Unmap();
+
+#   ifdef _WIN32
+    HANDLE file = CreateFileA(filepath.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER length;
+    if (!GetFileSizeEx(file, &length) || length.QuadPart <= 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // The mapping keeps the file open, its handle isn't needed past this point
+    HANDLE fileMapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (fileMapping == nullptr)
+        return false;
+
+    const void* view = MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr)
+    {
+        CloseHandle(fileMapping);
+        return false;
+    }
+
+    mapping = fileMapping;
+    data = (const Byte*) view;
+    size = (size_t) length.QuadPart;
+#   else
+    int file = open(filepath.data(), O_RDONLY);
+    if (file < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(file, &info) != 0 || info.st_size <= 0)
+    {
+        close(file);
+        return false;
+    }
+
+    // The mapping keeps the file open, the descriptor isn't needed past this point
+    void* view = mmap(nullptr, (size_t) info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+
+    if (view == MAP_FAILED)
+        return false;
+
+    data = (const Byte*) view;
+    size = (size_t) info.st_size;
+#   endif
+
+    return true;
+}
+
+void MappedFile::Unmap()
+{
+    if (data == nullptr)
+        return;
+
+#   ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle((HANDLE) mapping);
+#   else
+    munmap((void*) data, size);
+#   endif
+
+    data = nullptr;
+    size = 0;
+    mapping = nullptr;
+}
+
+bool SaveBinaryFile(const std::string_view& filepath, const void* data, size_t size)
+{
+    FILE* file = fopen(filepath.data(), "wb");
+    if (file == nullptr)
+        return false;
+
+    size_t written = fwrite(data, sizeof(Byte), size, file);
+
+    fclose(file);
+    return written == size;
+}
+
+std::string GetCacheDirectory()
+{
+    std::filesystem::path directory;
+
+#   ifdef _WIN32
+    if (const char* localAppData = getenv("LOCALAPPDATA"))
+        directory = std::filesystem::path(localAppData) / "Spedit" / "cache";
+#   else
+    if (const char* cacheHome = getenv("XDG_CACHE_HOME"))
+        directory = std::filesystem::path(cacheHome) / "spedit";
+    else if (const char* home = getenv("HOME"))
+        directory = std::filesystem::path(home) / ".cache" / "spedit";
+#   endif
+
+    if (directory.empty())
+        return std::string();
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    if (error)
+        return std::string();
+
+    return directory.string();
+}
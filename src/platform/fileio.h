@@ -5,4 +5,24 @@
 #include "math/types.h"
 
 std::string LoadFile(const std::string_view& filepath);
-gn::darray<Byte> LoadBinaryFile(const std::string_view& filepath);
\ No newline at end of file
+gn::darray<Byte> LoadBinaryFile(const std::string_view& filepath);
+
+// Read only view of a whole file, mapped instead of read so the contents aren't copied into a buffer first
+struct MappedFile
+{
+    const Byte* data = nullptr;
+    size_t size = 0;
+
+    void* mapping = nullptr;    // Mapping object on Windows, unused elsewhere
+
+    // Returns false for files that can't be opened or are empty, like caches that weren't written yet
+    bool Map(const std::string_view& filepath);
+    void Unmap();
+};
+
+bool SaveBinaryFile(const std::string_view& filepath, const void* data, size_t size);
+
+// Per user directory for files that can be rebuilt, %LOCALAPPDATA%\Spedit\cache on Windows and
+// $XDG_CACHE_HOME/spedit (or ~/.cache/spedit) elsewhere. Created if it's missing.
+// Empty if there's nowhere to put it, callers should carry on without caching.
+std::string GetCacheDirectory();
\ No newline at end of file
@@ -1,14 +1,18 @@
 #pragma once
 
 #include <string>
-#include "containers/darray.h"
+#include "containers/slot_map.h"
+#include "math/irect.h"
 #include "math/types.h"
 
-struct AnimationFrame
+// Frames are stored a field per array so batch code can stream over the rects alone.
+// Rows are (rect, pivot), rect is in image pixels with y going up from the bottom row, same as the loaded texture.
+using AnimationFrames = gn::soa_slot_map<IRect, Vector2>;
+
+enum AnimationFrameField : size_t
 {
-    Vector2 topLeft;
-    Vector2 size;
-    Vector2 pivot;
+    FRAME_RECT,
+    FRAME_PIVOT
 };
 
 struct Animation
@@ -24,10 +28,9 @@ struct Animation
     std::string name;
     f32 frameRate { 30.0f };
     LoopType loopType { LoopType::NONE };
-    gn::darray<AnimationFrame> frames;
+    AnimationFrames frames;
 
     Animation(const std::string& name);
-    ~Animation() = default;
 
     const char* GetLoopTypeName() const;
 };
\ No newline at end of file
@@ -1,14 +1,17 @@
 #pragma once
 
 #include "math/types.h"
-#include "engine/ui.h"
+#include "platform/application.h"
 
-struct BackgroundTexture
+// Transparency pattern behind the image, one cell per image pixel.
+// Drawn procedurally by the UI shader so it needs no texture whatever the image size.
+struct Background
 {
-    UI::Image image;
+    s32 width = 0, height = 0;
 
     void CreateDefault();
-    void Create(f32 width, f32 height);
-    void Free();
-    void SetScale(const Vector2& scale);
+    void Create(s32 width, s32 height);
+
+    // Expects the view to map image pixels
+    void Render(Application& app, Vector3 topLeft) const;
 };
\ No newline at end of file
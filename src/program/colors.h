@@ -2,9 +2,9 @@
 
 #include "math/types.h"
 
-static const Vector4 white  (1.0f, 1.0f, 1.0f, 1.0f);
-static const Vector4 grey   (0.25f, 0.25f, 0.25f, 0.75f);
-static const Vector4 red    (1.0f, 0.25f, 0.25f, 0.25f);
-static const Vector4 green  (0.25f, 1.0f, 0.25f, 0.25f);
-static const Vector4 lgreen (0.65f, 1.0f, 0.65f, 0.25f);
-static const Vector4 orange (1.0f, 0.8f, 0.25f, 0.25f);
\ No newline at end of file
+constexpr Vector4 white  (1.0f, 1.0f, 1.0f, 1.0f);
+constexpr Vector4 grey   (0.25f, 0.25f, 0.25f, 0.75f);
+constexpr Vector4 red    (1.0f, 0.25f, 0.25f, 0.25f);
+constexpr Vector4 green  (0.25f, 1.0f, 0.25f, 0.25f);
+constexpr Vector4 lgreen (0.65f, 1.0f, 0.65f, 0.25f);
+constexpr Vector4 orange (1.0f, 0.8f, 0.25f, 0.25f);
\ No newline at end of file
@@ -1,7 +1,8 @@
 #pragma once
 
 #include "animation.h"
-#include "containers/darray.h"
+#include "containers/bitmap2d.h"
+#include "containers/slot_map.h"
 #include "engine/ui.h"
 #include "misc/gn_assert.h"
 
@@ -15,22 +16,32 @@ struct Context
     UI::Image image;
     bool imageLoaded = false;
     bool imageLoadError = false;
+    gn::bitmap2d opaquePixels;      // One bit per pixel with non zero alpha, rebuilt on load
 
     // Animations
-    gn::darray<Animation> animations;
-    s32 selectedAnimationIndex = -1;
-    s32 selectedFrameIndex = -1;
+    gn::slot_map<Animation> animations;
+    gn::slot_handle selectedAnimation;
+    gn::slot_handle selectedFrame;
+
+    bool AnimationSelected() const
+    {
+        return animations.contains(selectedAnimation);
+    }
+
+    bool FrameSelected() const
+    {
+        return AnimationSelected() && animations[selectedAnimation].frames.contains(selectedFrame);
+    }
 
     Animation& CurrentAnimation()
     {
-        ASSERT(selectedAnimationIndex != -1);
-        return animations[selectedAnimationIndex];
+        ASSERT(AnimationSelected());
+        return animations[selectedAnimation];
     }
 
-    AnimationFrame& CurrentAnimationFrame()
+    AnimationFrames::reference CurrentAnimationFrame()
     {
-        ASSERT(selectedAnimationIndex != -1);
-        ASSERT(selectedFrameIndex != -1);
-        return CurrentAnimation().frames[selectedFrameIndex];
+        ASSERT(FrameSelected());
+        return CurrentAnimation().frames[selectedFrame];
     }
 };
\ No newline at end of file
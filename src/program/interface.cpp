@@ -1,7 +1,7 @@
 #include <sstream>
 #include <string>
 #include "math/types.h"
-#include "containers/darray.h"
+#include "containers/slot_map.h"
 #include "engine/ui.h"
 #include "platform/application.h"
 #include "animation.h"
@@ -89,7 +89,7 @@ bool RenderNewAnimationDialog(Application& app, const UI::Font& font, Context& c
             if (defaultName.length() <= 0)
                 return false;
 
-            context.animations.emplace_back(defaultName);
+            context.animations.emplace(defaultName);
 
             std::stringstream ss;
             ss << "animation_" << numAnimations;
@@ -174,46 +174,32 @@ static void RenderRenameAnimationDialog(Application& app, const UI::Font& font,
     }
 }
 
-static bool FrameNotEmpty(const Context& context, const AnimationFrame& frame)
+static bool FrameNotEmpty(const Context& context, const IRect& frameRect)
 {
-    u32 yStart = frame.topLeft.y - frame.size.y;
-    u32 xStart = frame.topLeft.x;
-    u32 yEnd   = frame.topLeft.y;
-    u32 xEnd   = frame.topLeft.x + frame.size.x;
-
-    for (u32 y = yStart; y < yEnd; y++)
-    {
-        for (u32 x = xStart; x < xEnd; x++)
-        {
-            u32 pixelIndex = y * context.image.width + x;
-            if (context.image.pixels[4 * pixelIndex + 3] != 0)
-                return true;
-        }
-    }
+    IRect rect = ClipToImage(frameRect, context.image.width, context.image.height);
+    if (rect.Empty())
+        return false;
 
-    return false;
+    return context.opaquePixels.any_in_rect(rect.x, rect.y, rect.width, rect.height);
 }
 
-static void SplitSheet(Context& context, Vector2 frameSize)
+static void SplitSheet(Context& context, s32 frameWidth, s32 frameHeight)
 {
-    if (frameSize.x <= 0.0f || frameSize.y <= 0.0f)
+    if (frameWidth <= 0 || frameHeight <= 0)
         return;
     
     context.CurrentAnimation().frames.clear();
-    context.selectedFrameIndex = -1;
+    context.selectedFrame = gn::slot_handle();
 
-    f32 yEnd = context.image.height - frameSize.y;
-    f32 xEnd = context.image.width - frameSize.x;
-    for (f32 y = context.image.height; y >= frameSize.y; y -= frameSize.y)
+    // Rows go from the top of the image down, y is measured from the bottom
+    for (s32 top = context.image.height; top >= frameHeight; top -= frameHeight)
     {
-        for (f32 x = 0.0f; x <= xEnd; x += frameSize.x)
+        for (s32 x = 0; x + frameWidth <= context.image.width; x += frameWidth)
         {
-            AnimationFrame frame;
-            frame.topLeft = Vector2(x, y);
-            frame.size = frameSize;
+            IRect rect(x, top - frameHeight, frameWidth, frameHeight);
 
-            if (FrameNotEmpty(context, frame))
-                context.CurrentAnimation().frames.emplace_back(frame);
+            if (FrameNotEmpty(context, rect))
+                context.CurrentAnimation().frames.emplace(rect, Vector2());
         }
     }
 }
@@ -307,7 +293,7 @@ static void RenderSplitSheetDialog(Application& app, const UI::Font& font, Conte
         f32 x = (app.refScreenWidth - size.x - 20.0f) / 2.0f;
         if (UI::RenderTextButton(app, GenUIID(), text, font, Vector2(10.0f, 5.0f), Vector3(x, height, rect.topLeft.z)))
         {
-            SplitSheet(context,  Vector2(frameWidth, frameHeight));
+            SplitSheet(context, frameWidth, frameHeight);
             showSplitSheetDialogue = false;
         }
 
@@ -385,9 +371,9 @@ Vector2 RenderAnimationInfo(Application& app, const UI::Font& font, Context& con
 
         if (UI::RenderTextButton(app, GenUIID(), text, font, Vector2(10.0f, 5.0f), Vector3(x, height, topLeft.z)))
         {
-            context.animations.erase_at(context.selectedAnimationIndex);
-            context.selectedAnimationIndex = -1;
-            context.selectedFrameIndex = -1;
+            context.animations.erase_ordered(context.selectedAnimation);
+            context.selectedAnimation = gn::slot_handle();
+            context.selectedFrame = gn::slot_handle();
         }
     }
 
@@ -436,7 +422,7 @@ void RenderFrameInfo(Application& app, const UI::Font& font, Context& context)
         initialized = true;
     }
 
-    AnimationFrame& frame = context.CurrentAnimationFrame();
+    auto [rect, pivot] = context.CurrentAnimationFrame();
 
     static const f32 y = app.refScreenHeight - UI::GetRenderedTextSize("F", font).y - 20.0f;
     f32 x = (app.refScreenWidth - windowWidth) / 2.0f;
@@ -447,12 +433,12 @@ void RenderFrameInfo(Application& app, const UI::Font& font, Context& context)
         UI::RenderText(app, label, font, white, Vector3(x, y, 0.0f));
 
         static std::string text;
-        s32 num = frame.topLeft.x;
+        s32 num = rect.x;
 
         Vector3 inputPos(x + size.x, y - 5.0f, 0.0f);
         UI::RenderNumericInputi(app, GenUIID(), num, text, font, Vector2(10.0f, 5.0f), inputPos, numericInputWidth);
 
-        frame.topLeft.x = num;
+        rect.x = num;
 
         x += size.x + numericInputWidth + hgap;
     }
@@ -463,14 +449,13 @@ void RenderFrameInfo(Application& app, const UI::Font& font, Context& context)
         UI::RenderText(app, label, font, white, Vector3(x, y, 0.0f));
 
         static std::string text;
-        s32 num = frame.topLeft.y;
+        // Shown as the top edge, measured from the bottom of the image
+        s32 num = rect.MaxY();
 
         Vector3 inputPos(x + size.x, y - 5.0f, 0.0f);
         UI::RenderNumericInputi(app, GenUIID(), num, text, font, Vector2(10.0f, 5.0f), inputPos, numericInputWidth);
 
-
-        
-        frame.topLeft.y = num;
+        rect.y = num - rect.height;
 
         x += size.x + numericInputWidth + hgap;
     }
@@ -481,12 +466,12 @@ void RenderFrameInfo(Application& app, const UI::Font& font, Context& context)
         UI::RenderText(app, label, font, white, Vector3(x, y, 0.0f));
 
         static std::string text;
-        s32 num = frame.size.x;
+        s32 num = rect.width;
 
         Vector3 inputPos(x + size.x, y - 5.0f, 0.0f);
         UI::RenderNumericInputi(app, GenUIID(), num, text, font, Vector2(10.0f, 5.0f), inputPos, numericInputWidth);
 
-        frame.size.x = num;
+        rect.width = num;
 
         x += size.x + numericInputWidth + hgap;
     }
@@ -497,12 +482,14 @@ void RenderFrameInfo(Application& app, const UI::Font& font, Context& context)
         UI::RenderText(app, label, font, white, Vector3(x, y, 0.0f));
 
         static std::string text;
-        s32 num = frame.size.y;
+        s32 num = rect.height;
 
         Vector3 inputPos(x + size.x, y - 5.0f, 0.0f);
         UI::RenderNumericInputi(app, GenUIID(), num, text, font, Vector2(10.0f, 5.0f), inputPos, numericInputWidth);
 
-        frame.size.y = num;
+        // Keep the top edge in place
+        rect.y += rect.height - num;
+        rect.height = num;
 
         x += size.x + numericInputWidth + hgap;
     }
@@ -515,7 +502,7 @@ void RenderFrameInfo(Application& app, const UI::Font& font, Context& context)
         static std::string text;
 
         Vector3 inputPos(x + size.x, y - 5.0f, 0.0f);
-        UI::RenderNumericInputf(app, GenUIID(), frame.pivot.x, text, font, Vector2(10.0f, 5.0f), inputPos, numericInputWidth);
+        UI::RenderNumericInputf(app, GenUIID(), pivot.x, text, font, Vector2(10.0f, 5.0f), inputPos, numericInputWidth);
         
         x += size.x + numericInputWidth + hgap;
     }
@@ -528,7 +515,7 @@ void RenderFrameInfo(Application& app, const UI::Font& font, Context& context)
         static std::string text;
 
         Vector3 inputPos(x + size.x, y - 5.0f, 0.0f);
-        UI::RenderNumericInputf(app, GenUIID(), frame.pivot.y, text, font, Vector2(10.0f, 5.0f), inputPos, numericInputWidth);
+        UI::RenderNumericInputf(app, GenUIID(), pivot.y, text, font, Vector2(10.0f, 5.0f), inputPos, numericInputWidth);
         
         x += size.x + numericInputWidth + hgap;
     }
@@ -540,15 +527,15 @@ void RenderFrameInfo(Application& app, const UI::Font& font, Context& context)
         Vector3 position(x, y - 5.0f, 0.0f);
         if (app.GetKeyDown(KEY(DELETE)) || UI::RenderTextButton(app, GenUIID(), text, font, Vector2(10.0f, 5.0f), position))
         {
-            context.CurrentAnimation().frames.erase_at(context.selectedFrameIndex);
-            context.selectedFrameIndex = -1;
+            context.CurrentAnimation().frames.erase_ordered(context.selectedFrame);
+            context.selectedFrame = gn::slot_handle();
         }
 
         x += size.x + hgap;
     }
 }
 
-void ResetAnimations(gn::darray<Animation>& animations)
+void ResetAnimations(gn::slot_map<Animation>& animations)
 {
     animations.clear();
     numAnimations = 1;
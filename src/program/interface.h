@@ -1,6 +1,6 @@
 #pragma once
 
-#include "containers/darray.h"
+#include "containers/slot_map.h"
 #include "engine/ui.h"
 #include "platform/application.h"
 #include "animation.h"
@@ -15,4 +15,4 @@ Vector2 RenderAnimationInfo(Application& app, const UI::Font& font, Context& con
 
 void RenderFrameInfo(Application& app, const UI::Font& font, Context& context);
 
-void ResetAnimations(gn::darray<Animation>& animations);
\ No newline at end of file
+void ResetAnimations(gn::slot_map<Animation>& animations);
\ No newline at end of file
@@ -97,10 +97,9 @@ void OutputToJSONFile(const Context& context)
             else
                 fprintf(outfile, "\n");
             
-            const AnimationFrame& frame = animation.frames[j];
+            auto [rect, pivot] = animation.frames[j];
 
-            // Inverting y axis texCoords
-            fprintf(outfile, frameFormat, (int) frame.topLeft.x, (int) frame.topLeft.y - (int) frame.size.y, (int) frame.topLeft.x + (int) frame.size.x, (int) frame.topLeft.y, frame.pivot.x, frame.pivot.y);
+            fprintf(outfile, frameFormat, rect.x, rect.y, rect.MaxX(), rect.MaxY(), pivot.x, pivot.y);
         }
 
         if (animation.frames.size() > 0)
@@ -142,7 +141,7 @@ bool LoadFromJSONFile(const std::string& jsonfile, Context& context)
     for (auto& animObject : docObject["animations"].array())
     {
         auto& name = animObject["name"].string();
-        Animation& animation = context.animations.emplace_back(name);
+        Animation& animation = context.animations[context.animations.emplace(name)];
 
         auto& loopTypeName = animObject["loopType"].string();
         if (loopTypeName == "None")
@@ -156,16 +155,18 @@ bool LoadFromJSONFile(const std::string& jsonfile, Context& context)
 
         for (auto& frameObject : animObject["frames"].array())
         {
-            AnimationFrame& frame = animation.frames.emplace_back();
+            auto [rect, pivot] = animation.frames[animation.frames.emplace()];
 
-            frame.topLeft.x = frameObject["left"].int64();
-            frame.topLeft.y = frameObject["top"].int64();
-            frame.size.x = frameObject["right"].int64() - frame.topLeft.x;
-            frame.size.y = frameObject["top"].int64() - frameObject["bottom"].int64();
+            rect = IRectFromCorners((s32) frameObject["left"].int64(),  (s32) frameObject["bottom"].int64(),
+                                    (s32) frameObject["right"].int64(), (s32) frameObject["top"].int64());
 
-            frame.pivot.x = frameObject["pivot_x"].float64();
-            frame.pivot.y = frameObject["pivot_y"].float64();
+            pivot.x = frameObject["pivot_x"].float64();
+            pivot.y = frameObject["pivot_y"].float64();
         }
+
+        // Hand edited files can have frames hanging off the image
+        IRect imageBounds(0, 0, context.image.width, context.image.height);
+        ClipRects(animation.frames.dense().field<FRAME_RECT>(), sizeof(IRect), animation.frames.size(), imageBounds);
     }
 
     return true;